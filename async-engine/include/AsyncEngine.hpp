@@ -17,6 +17,7 @@ limitations under the License.
 #include <emscripten/val.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <future>
 #include <map>
@@ -25,6 +26,8 @@ limitations under the License.
 #include <type_traits>
 #include <vector>
 
+#include "RingBuffer.hpp"
+
 namespace privmx {
 namespace webendpoint {
 
@@ -91,12 +94,37 @@ public:
 
     /**
      * @brief Sets the JavaScript callback function that receives results from worker tasks.
-     * * When a task posted via `postWorkerTask` completes, this callback is invoked 
-     * on the Main Thread with the result object.
+     * * When tasks posted via `postWorkerTask` complete, their results are collected in a shared
+     * completion ring and this callback is invoked on the Main Thread with an array of result
+     * objects, drained in one batch.
      * * @param callback A JavaScript function handle (emscripten::val).
      */
     void setResultsCallback(emscripten::val callback);
 
+    // --- Event Pump API ---
+
+    /**
+     * @brief Starts a dedicated thread that pulls event batches and pushes them to JavaScript.
+     * * The pump thread calls `source` in a loop. `source` may block until events are available and
+     * returns them as an array `Poco::Dynamic::Var`. Each non-empty batch is mapped on the Main Thread
+     * and delivered to `callback` in a single call. The pump does not occupy any WorkerPool thread.
+     * If `source` throws, the pump ends and `callback` receives `(null, error)`; it still has to be
+     * stopped with `stopEventPump` before another one can start.
+     * * Must be called on the Browser Main Thread (the `callback` handle belongs to it).
+     * @param source Blocking function returning the next batch of events.
+     * @param callback A JavaScript function handle receiving an array of events.
+     * @return `false` if a pump is already running or still stopping.
+     */
+    bool startEventPump(std::function<Poco::Dynamic::Var(void)> source, emscripten::val callback);
+
+    /**
+     * @brief Stops the event pump and joins its thread.
+     * * @param wakeUp Function unblocking a pending `source` call (e.g. emitting a break event). Called
+     * again until the pump has left `source`, as another reader may consume what it emitted.
+     * @note Must not be called on the Browser Main Thread.
+     */
+    void stopEventPump(const std::function<void(void)>& wakeUp);
+
     // --- Thread Dispatch API ---
 
     /**
@@ -166,6 +194,23 @@ private:
     void executeWorkerTask(int taskId, const std::function<Poco::Dynamic::Var(void)>& task);
     void executeWorkerTask(int taskId, const std::function<void(void)>& task);
     void postResultToMain(const Poco::Dynamic::Var& result);
+    void submitToPool(std::function<void(void)> job);
+    void drainCompletions();
+
+    // Completion ring shared between pool workers (producers) and the Main Thread (consumer)
+    RingBuffer<Poco::Dynamic::Var> _completions{1024};
+    std::atomic<bool> _drainScheduled{false};
+
+    // Event pump state
+    enum class EventPumpState { Idle, Running, Stopping };
+    void eventPumpLoop(std::function<Poco::Dynamic::Var(void)> source);
+    std::mutex _eventPumpMutex;  ///< Guards the fields below; never held across a join or a proxied call.
+    std::condition_variable _eventPumpExited;
+    EventPumpState _eventPumpState = EventPumpState::Idle;
+    bool _eventPumpLoopDone = false;  ///< Set by the pump thread once it no longer calls `source`.
+    std::thread _eventPumpThread;
+    std::atomic<bool> _eventPumpRunning{false};
+    emscripten::val _eventPumpCallback = emscripten::val::undefined();  ///< Lives on the Main Thread only.
 
     // Remote Call State management
     std::mutex _promiseMutex;
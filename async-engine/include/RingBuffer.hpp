@@ -0,0 +1,146 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <emscripten/threading.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace privmx {
+namespace webendpoint {
+
+/**
+ * @class RingBuffer
+ * @brief Bounded lock-free multi-producer/multi-consumer queue living in the shared wasm heap.
+ * * Every slot carries its own sequence number, so producers and consumers only contend on a single
+ * atomic index each and never take a lock. This makes `tryPush` safe to call from the Browser Main
+ * Thread, where blocking on a mutex is not allowed.
+ * * Consumers that find the ring empty may park on `wait()`, which is an `Atomics.wait` on the
+ * signal word; producers wake them with `notify()`.
+ * @tparam T Element type. Must be default constructible and move assignable.
+ */
+template<typename T>
+class RingBuffer {
+public:
+    /**
+     * @param capacity Number of slots, rounded up to the next power of two.
+     */
+    explicit RingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        _mask = size - 1;
+        _slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Appends an element without blocking.
+     * @return `false` if the ring is full; `value` is left untouched in that case.
+     */
+    bool tryPush(T&& value) {
+        size_t pos = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[pos & _mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element without blocking.
+     * @return `false` if the ring is empty.
+     */
+    bool tryPop(T& out) {
+        size_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[pos & _mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.value = T();
+                    slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the current value of the signal word, to be passed to `wait()`.
+     */
+    uint32_t signal() const { return _signal.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Blocks the calling worker until `notify()` is called after `seen` was read.
+     * * Must not be called on the Browser Main Thread.
+     */
+    void wait(uint32_t seen) {
+        _sleepers.fetch_add(1);
+        if (_signal.load() == seen) {
+            emscripten_futex_wait(&_signal, seen, INFINITY);
+        }
+        _sleepers.fetch_sub(1);
+    }
+
+    /**
+     * @brief Wakes up to `count` consumers parked in `wait()`.
+     */
+    void notify(int count = 1) {
+        _signal.fetch_add(1);
+        if (_sleepers.load() > 0) {
+            emscripten_futex_wake(&_signal, count);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask;
+    alignas(64) std::atomic<size_t> _tail{0};
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<uint32_t> _signal{0};
+    std::atomic<int> _sleepers{0};
+};
+
+}  // namespace webendpoint
+}  // namespace privmx
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <mutex>
@@ -9,12 +8,14 @@
 #include <thread>
 #include <vector>
 
+#include "RingBuffer.hpp"
+
 namespace privmx {
 namespace webendpoint {
 
 class WorkerPool {
 public:
-    explicit WorkerPool(size_t numThreads);
+    explicit WorkerPool(size_t numThreads, size_t ringCapacity = 1024);
     ~WorkerPool();
 
     WorkerPool(const WorkerPool&) = delete;
@@ -24,16 +25,21 @@ public:
 
     void enqueue(std::function<void()> task);
 
+    // Lock-free submission, safe on the Browser Main Thread. Returns false when the ring is full.
+    bool tryEnqueue(std::function<void()>& task);
+
 private:
     void worker_loop();
+    bool next_task(std::function<void()>& task);
 
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    RingBuffer<std::function<void()>> ring;
+    std::queue<std::function<void()>> overflow;
 
-    std::mutex queue_mutex;
-    std::condition_variable condition;
+    std::mutex overflow_mutex;
+    std::atomic<size_t> overflow_size;
     std::atomic<bool> stop;
 };
 
 }  // namespace webendpoint
-}  // namespace privmx
\ No newline at end of file
+}  // namespace privmx
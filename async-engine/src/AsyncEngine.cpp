@@ -11,11 +11,13 @@ limitations under the License.
 
 #include "AsyncEngine.hpp"
 
+#include <Poco/JSON/Array.h>
 #include <Poco/JSON/Object.h>
 #include <Pson/pson.h>
 #include <emscripten/eventloop.h>
 
 #include <Pson/BinaryString.hpp>
+#include <chrono>
 #include <stdexcept>
 
 #include "Mapper.hpp"
@@ -46,11 +48,47 @@ namespace privmx {
             const value = Emval.toValue(valueHandle);
             setTimeout(()=>callback(value), 0);
         });
+
+        EM_JS(void, pushErrorToJsCallbackQueue,(emscripten::EM_VAL callbackHandle, emscripten::EM_VAL errorHandle), {
+            const callback = Emval.toValue(callbackHandle);
+            const error = Emval.toValue(errorHandle);
+            setTimeout(()=>callback(null, error), 0);
+        });
     }
 }
 
 // clang-format on
 
+namespace {
+
+// How long stopEventPump waits for the pump to leave its source before waking it up again.
+constexpr std::chrono::milliseconds EVENT_PUMP_WAKE_UP_RETRY{100};
+
+Poco::JSON::Object::Ptr describeError(const AsyncEngine::ErrorHandler& errorHandler, std::exception_ptr error) {
+    Poco::JSON::Object::Ptr errorObj = new Poco::JSON::Object();
+    bool handled = false;
+    if (errorHandler) {
+        try {
+            errorHandler(error, errorObj);
+            handled = true;
+        } catch (...) {
+            errorObj->set("error", "Error handler crashed");
+        }
+    }
+    if (!handled || errorObj->size() == 0) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            errorObj->set("error", e.what());
+        } catch (...) {
+            errorObj->set("error", "Unknown Error");
+        }
+    }
+    return errorObj;
+}
+
+}  // namespace
+
 AsyncEngine* AsyncEngine::_instance = nullptr;
 std::mutex AsyncEngine::_instanceMutex;
 pthread_t AsyncEngine::_mainThread = pthread_self();
@@ -70,13 +108,20 @@ AsyncEngine::AsyncEngine() {
 AsyncEngine::~AsyncEngine() {}
 
 void AsyncEngine::_postWorkerTaskVar(int taskId, const std::function<Poco::Dynamic::Var(void)>& task) {
-    _proxingQueue.proxyAsync(_taskManagerThread.native_handle(),
-                             [&, taskId, task] { executeWorkerTask(taskId, task); });
+    executeWorkerTask(taskId, task);
 }
 
 void AsyncEngine::_postWorkerTaskVoid(int taskId, const std::function<void(void)>& task) {
-    _proxingQueue.proxyAsync(_taskManagerThread.native_handle(),
-                             [&, taskId, task] { executeWorkerTask(taskId, task); });
+    executeWorkerTask(taskId, task);
+}
+
+void AsyncEngine::submitToPool(std::function<void(void)> job) {
+    // Fast path: lock-free push into the pool's submission ring, directly from the calling thread.
+    if (_pool->tryEnqueue(job)) {
+        return;
+    }
+    // Ring is full - hand the job over to the task manager thread, which may block on the overflow queue.
+    _proxingQueue.proxyAsync(_taskManagerThread.native_handle(), [&, job] { _pool->enqueue(job); });
 }
 
 void AsyncEngine::setResultsCallback(emscripten::val callback) {
@@ -85,7 +130,7 @@ void AsyncEngine::setResultsCallback(emscripten::val callback) {
 
 void AsyncEngine::executeWorkerTask(int taskId, const std::function<Poco::Dynamic::Var(void)>& task) {
     auto errorHandler = _errorHandler;
-    _pool->enqueue([=] {
+    submitToPool([=] {
         Poco::JSON::Object::Ptr result = new Poco::JSON::Object();
         result->set("taskId", taskId);
         try {
@@ -93,26 +138,7 @@ void AsyncEngine::executeWorkerTask(int taskId, const std::function<Poco::Dynami
             result->set("status", true);
         } catch (...) {
             result->set("status", false);
-            Poco::JSON::Object::Ptr errorObj = new Poco::JSON::Object();
-            bool handled = false;
-            if (errorHandler) {
-                try {
-                    errorHandler(std::current_exception(), errorObj);
-                    handled = true;
-                } catch (...) {
-                    errorObj->set("error", "Error handler crashed");
-                }
-            }
-            if (!handled || errorObj->size() == 0) {
-                try {
-                    throw;
-                } catch (const std::exception& e) {
-                    errorObj->set("error", e.what());
-                } catch (...) {
-                    errorObj->set("error", "Unknown Error");
-                }
-            }
-            result->set("error", errorObj);
+            result->set("error", describeError(errorHandler, std::current_exception()));
         }
         postResultToMain(result);
     });
@@ -120,7 +146,7 @@ void AsyncEngine::executeWorkerTask(int taskId, const std::function<Poco::Dynami
 
 void AsyncEngine::executeWorkerTask(int taskId, const std::function<void(void)>& task) {
     auto errorHandler = _errorHandler;
-    _pool->enqueue([=] {
+    submitToPool([=] {
         Poco::JSON::Object::Ptr result = new Poco::JSON::Object();
         result->set("taskId", taskId);
         try {
@@ -129,32 +155,21 @@ void AsyncEngine::executeWorkerTask(int taskId, const std::function<void(void)>&
             task();
         } catch (...) {
             result->set("status", false);
-            Poco::JSON::Object::Ptr errorObj = new Poco::JSON::Object();
-            bool handled = false;
-            if (errorHandler) {
-                try {
-                    errorHandler(std::current_exception(), errorObj);
-                    handled = true;
-                } catch (...) {
-                    errorObj->set("error", "Error handler crashed");
-                }
-            }
-            if (!handled || errorObj->size() == 0) {
-                try {
-                    throw;
-                } catch (const std::exception& e) {
-                    errorObj->set("error", e.what());
-                } catch (...) {
-                    errorObj->set("error", "Unknown Error");
-                }
-            }
-            result->set("error", errorObj);
+            result->set("error", describeError(errorHandler, std::current_exception()));
         }
         postResultToMain(result);
     });
 }
 
 void AsyncEngine::postResultToMain(const Poco::Dynamic::Var& result) {
+    Poco::Dynamic::Var completion = result;
+    if (_completions.tryPush(std::move(completion))) {
+        // Only the first completion after a drain schedules a new one; the rest are picked up in the same batch.
+        if (!_drainScheduled.exchange(true)) {
+            _proxingQueue.proxyAsync(_mainThread, [&] { drainCompletions(); });
+        }
+        return;
+    }
     dispatchToMainThread([&, result] {
         if (!_callback.isUndefined()) {
             Poco::Dynamic::Var localResult = result;
@@ -164,6 +179,101 @@ void AsyncEngine::postResultToMain(const Poco::Dynamic::Var& result) {
     });
 }
 
+void AsyncEngine::drainCompletions() {
+    _drainScheduled.store(false);
+    emscripten::val batch = emscripten::val::array();
+    Poco::Dynamic::Var completion;
+    while (_completions.tryPop(completion)) {
+        if (!_callback.isUndefined()) {
+            batch.call<void>("push", Mapper::map((pson_value*)&completion));
+        }
+    }
+    if (!_callback.isUndefined() && batch["length"].as<int>() > 0) {
+        pushToJsCallbackQueue(_callback.as_handle(), batch.as_handle());
+    }
+}
+
+bool AsyncEngine::startEventPump(std::function<Poco::Dynamic::Var(void)> source, emscripten::val callback) {
+    std::lock_guard<std::mutex> lock(_eventPumpMutex);
+    if (_eventPumpState != EventPumpState::Idle) {
+        return false;
+    }
+    _eventPumpState = EventPumpState::Running;
+    _eventPumpLoopDone = false;
+    _eventPumpCallback = callback;
+    _eventPumpRunning = true;
+    _eventPumpThread = std::thread([this, source] { eventPumpLoop(source); });
+    return true;
+}
+
+void AsyncEngine::stopEventPump(const std::function<void(void)>& wakeUp) {
+    std::thread pumpThread;
+    {
+        std::unique_lock<std::mutex> lock(_eventPumpMutex);
+        if (_eventPumpState != EventPumpState::Running) {
+            return;
+        }
+        _eventPumpState = EventPumpState::Stopping;
+        _eventPumpRunning = false;
+        // A blocked source only returns on an event, and any other reader of the same queue may consume the one
+        // wakeUp emits, so it is repeated until the pump reports it has left the loop.
+        while (!_eventPumpLoopDone) {
+            lock.unlock();
+            wakeUp();
+            lock.lock();
+            _eventPumpExited.wait_for(lock, EVENT_PUMP_WAKE_UP_RETRY, [this] { return _eventPumpLoopDone; });
+        }
+        pumpThread = std::move(_eventPumpThread);
+    }
+    // The Main Thread may call startEventPump meanwhile, so _eventPumpMutex is released before blocking here
+    pumpThread.join();
+    dispatchToMainThread([&] { _eventPumpCallback = emscripten::val::undefined(); });
+    std::lock_guard<std::mutex> lock(_eventPumpMutex);
+    _eventPumpState = EventPumpState::Idle;
+}
+
+void AsyncEngine::eventPumpLoop(std::function<Poco::Dynamic::Var(void)> source) {
+    std::exception_ptr error;
+    while (_eventPumpRunning) {
+        Poco::Dynamic::Var batch;
+        try {
+            batch = source();
+        } catch (...) {
+            error = std::current_exception();
+            break;
+        }
+        if (!_eventPumpRunning) {
+            break;
+        }
+        // The source returns early and empty when woken up while running
+        if (batch.type() == typeid(Poco::JSON::Array::Ptr) && batch.extract<Poco::JSON::Array::Ptr>()->size() == 0) {
+            continue;
+        }
+        // Delivered synchronously: a slow consumer on the Main Thread holds back the pump, not the pool.
+        dispatchToMainThread([&] {
+            if (!_eventPumpCallback.isUndefined()) {
+                emscripten::val events = Mapper::map((pson_value*)&batch);
+                pushToJsCallbackQueue(_eventPumpCallback.as_handle(), events.as_handle());
+            }
+        });
+    }
+    if (error && _eventPumpRunning) {
+        // The pump is done; the consumer has to stop it and fall back to polling
+        Poco::Dynamic::Var errorVar = describeError(_errorHandler, error);
+        dispatchToMainThread([&] {
+            if (!_eventPumpCallback.isUndefined()) {
+                emscripten::val errorVal = Mapper::map((pson_value*)&errorVar);
+                pushErrorToJsCallbackQueue(_eventPumpCallback.as_handle(), errorVal.as_handle());
+            }
+        });
+    }
+    {
+        std::lock_guard<std::mutex> lock(_eventPumpMutex);
+        _eventPumpLoopDone = true;
+    }
+    _eventPumpExited.notify_all();
+}
+
 void AsyncEngine::dispatchToMainThread(const std::function<void(void)>& task) {
     if (pthread_self() != _mainThread) {
         _proxingQueue.proxySync(_mainThread, [&] { task(); });
@@ -5,19 +5,16 @@
 namespace privmx {
 namespace webendpoint {
 
-WorkerPool::WorkerPool(size_t numThreads) : stop(false) {
+WorkerPool::WorkerPool(size_t numThreads, size_t ringCapacity)
+    : ring(ringCapacity), overflow_size(0), stop(false) {
     for (size_t i = 0; i < numThreads; ++i) {
         workers.emplace_back([this] { this->worker_loop(); });
     }
 }
 
 WorkerPool::~WorkerPool() {
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        stop = true;
-    }
-
-    condition.notify_all();
+    stop = true;
+    ring.notify(static_cast<int>(workers.size()));
 
     for (std::thread& worker : workers) {
         if (worker.joinable()) {
@@ -27,29 +24,55 @@ WorkerPool::~WorkerPool() {
 }
 
 void WorkerPool::enqueue(std::function<void()> task) {
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        if (stop) {
-            return;
-        }
-        tasks.emplace(std::move(task));
+    if (stop) {
+        return;
+    }
+    if (!ring.tryPush(std::move(task))) {
+        std::unique_lock<std::mutex> lock(overflow_mutex);
+        overflow.emplace(std::move(task));
+        overflow_size++;
+    }
+    ring.notify();
+}
+
+bool WorkerPool::tryEnqueue(std::function<void()>& task) {
+    if (stop) {
+        return true;
+    }
+    if (!ring.tryPush(std::move(task))) {
+        return false;
     }
-    condition.notify_one();
+    ring.notify();
+    return true;
+}
+
+bool WorkerPool::next_task(std::function<void()>& task) {
+    if (ring.tryPop(task)) {
+        return true;
+    }
+    if (overflow_size.load() == 0) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(overflow_mutex);
+    if (overflow.empty()) {
+        return false;
+    }
+    task = std::move(overflow.front());
+    overflow.pop();
+    overflow_size--;
+    return true;
 }
 
 void WorkerPool::worker_loop() {
     while (true) {
         std::function<void()> task;
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
-
-            if (this->stop && this->tasks.empty()) {
+        uint32_t seen = ring.signal();
+        if (!next_task(task)) {
+            if (stop) {
                 return;
             }
-
-            task = std::move(tasks.front());
-            tasks.pop();
+            ring.wait(seen);
+            continue;
         }
 
         try {
@@ -59,4 +82,4 @@ void WorkerPool::worker_loop() {
 }
 
 }  // namespace webendpoint
-}  // namespace privmx
\ No newline at end of file
+}  // namespace privmx
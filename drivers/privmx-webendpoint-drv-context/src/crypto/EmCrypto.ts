@@ -13,10 +13,15 @@ import * as elliptic from "elliptic";
 import { assertIsNumber, assertIsUint8Array, assertArgsValid, assertIsString } from "../assert";
 import * as Types from "./Types";
 import * as Utils from "./Utils";
+import { KeyCache } from "./KeyCache";
+import { KemCache } from "./KemCache";
 import BN = require("bn.js");
 const EC = new elliptic.ec("secp256k1");
 const {subtle} = globalThis.crypto;
 const crypto = require('crypto');
+// Module level: methodCaller invokes the methods with methodsMap as `this`
+const keyCache = new KeyCache();
+const kemCache = new KemCache();
 
 export class EmCrypto {
     static HASH_ALGORITHM_MAP: {[name: string]: string} = {
@@ -45,6 +50,8 @@ export class EmCrypto {
         aes256CbcPkcs7Decrypt: this.aes256CbcPkcs7Decrypt,
         aes256CbcNoPadEncrypt: this.aes256CbcNoPadEncrypt,
         aes256CbcNoPadDecrypt: this.aes256CbcNoPadDecrypt,
+        aes256GcmEncrypt: this.aes256GcmEncrypt,
+        aes256GcmDecrypt: this.aes256GcmDecrypt,
         prf_tls12: this.prf_tls12,
         kdf: this.kdf,
         getKEM: this.getKEM,
@@ -67,7 +74,10 @@ export class EmCrypto {
         point_mul: this.pointMul,
         point_add: this.pointAdd,
         fillWithZeroesTo32: this.fillWithZeroesTo32,
-        getRecoveryParam: this.getRecoveryParam
+        getRecoveryParam: this.getRecoveryParam,
+        keyCacheConfigure: this.keyCacheConfigure,
+        keyCacheClear: this.keyCacheClear,
+        keyCacheStats: this.keyCacheStats
      };
 
     async methodCaller(name: string, params: any): Promise<any> {
@@ -103,26 +113,26 @@ export class EmCrypto {
 
 
     private async hmacSha1(key: ArrayBuffer, data: ArrayBuffer): Promise<ArrayBuffer> {
-        const importedKey = await subtle.importKey("raw", new Uint8Array(key), {
+        const importedKey = await keyCache.importKey(new Uint8Array(key), {
             name: "HMAC",
             hash: "SHA-1"
-        }, false, ["sign"]);
+        }, ["sign"]);
         return await subtle.sign("HMAC", importedKey, new Uint8Array(data));
     }
 
     private async hmacSha256(key: ArrayBuffer, data: ArrayBuffer): Promise<ArrayBuffer> {
-        const importedKey = await subtle.importKey("raw", new Uint8Array(key), {
+        const importedKey = await keyCache.importKey(new Uint8Array(key), {
             name: "HMAC",
             hash: "SHA-256"
-        }, false, ["sign"]);
+        }, ["sign"]);
         return subtle.sign("HMAC", importedKey, new Uint8Array(data));
     }
 
     private async hmacSha512(key: ArrayBuffer, data: ArrayBuffer): Promise<ArrayBuffer> {
-        const importedKey = await subtle.importKey("raw", new Uint8Array(key), {
+        const importedKey = await keyCache.importKey(new Uint8Array(key), {
             name: "HMAC",
             hash: "SHA-512"
-        }, false, ["sign"]);
+        }, ["sign"]);
         return subtle.sign("HMAC", importedKey, new Uint8Array(data));
     }
 
@@ -173,7 +183,7 @@ export class EmCrypto {
         assertIsUint8Array(params.data);
         assertIsUint8Array(params.key);
         assertIsUint8Array(params.iv);
-        const key = await subtle.importKey("raw", new Uint8Array(params.key), "AES-CBC", true, ["encrypt"]);
+        const key = await keyCache.importKey(new Uint8Array(params.key), "AES-CBC", ["encrypt", "decrypt"]);
         return subtle.encrypt({name: "AES-CBC", iv: new Uint8Array(params.iv)}, key, new Uint8Array(params.data));
     }
 
@@ -182,7 +192,7 @@ export class EmCrypto {
         assertIsUint8Array(params.data);
         assertIsUint8Array(params.key);
         assertIsUint8Array(params.iv);
-        const key = await subtle.importKey("raw", new Uint8Array(params.key), "AES-CBC", true, ["decrypt"]);
+        const key = await keyCache.importKey(new Uint8Array(params.key), "AES-CBC", ["encrypt", "decrypt"]);
         return subtle.decrypt({name: "AES-CBC", iv: new Uint8Array(params.iv)}, key, new Uint8Array(params.data));
     }
 
@@ -205,6 +215,39 @@ export class EmCrypto {
         return Utils.toArrayBuffer(Buffer.concat([cipher.update(params.data), cipher.final()]));
     }
 
+    // Returns ciphertext || 16-byte tag, as WebCrypto does.
+    private async aes256GcmEncrypt(params: Types.Aes256GcmEncrypt_PARAMS): Promise<ArrayBuffer> {
+        assertArgsValid(params, Types.Aes256GcmEncrypt_PARAMS);
+        assertIsUint8Array(params.data);
+        assertIsUint8Array(params.key);
+        assertIsUint8Array(params.iv);
+        assertIsUint8Array(params.aad);
+        const key = await keyCache.importKey(new Uint8Array(params.key), "AES-GCM", ["encrypt", "decrypt"]);
+        return subtle.encrypt({
+            name: "AES-GCM",
+            iv: new Uint8Array(params.iv),
+            additionalData: new Uint8Array(params.aad),
+            tagLength: 128
+        }, key, new Uint8Array(params.data));
+    }
+
+    private async aes256GcmDecrypt(params: Types.Aes256GcmDecrypt_PARAMS): Promise<ArrayBuffer> {
+        assertArgsValid(params, Types.Aes256GcmDecrypt_PARAMS);
+        assertIsUint8Array(params.data);
+        assertIsUint8Array(params.key);
+        assertIsUint8Array(params.iv);
+        assertIsUint8Array(params.aad);
+        assertIsUint8Array(params.tag);
+        const key = await keyCache.importKey(new Uint8Array(params.key), "AES-GCM", ["encrypt", "decrypt"]);
+        const input = Buffer.concat([new Uint8Array(params.data), new Uint8Array(params.tag)]);
+        return subtle.decrypt({
+            name: "AES-GCM",
+            iv: new Uint8Array(params.iv),
+            additionalData: new Uint8Array(params.aad),
+            tagLength: params.tag.byteLength * 8
+        }, key, input);
+    }
+
     private async prf_tls12(params: Types.Prf_tls12_PARAMS): Promise<ArrayBuffer> {
         assertArgsValid(params, Types.Prf_tls12_PARAMS);
         assertIsUint8Array(params.key);
@@ -251,7 +294,8 @@ export class EmCrypto {
         if (!kmLen && kmLen !== 0) {
             kmLen = 32;
         }
-        const kEM = await this.kdf(algo, keLen + kmLen, key, "key expansion");
+        const kEM = await kemCache.get(key, `${algo}:${keLen}:${kmLen}`,
+            () => this.kdf(algo, keLen + kmLen, key, "key expansion"));
         return {
             kE: kEM.slice(0, keLen),
             kM: kEM.slice(keLen)
@@ -282,10 +326,13 @@ export class EmCrypto {
         assertIsNumber(params.taglen);
         const kem = await this.getKEM("sha256", Buffer.from(params.key));
         let data = Buffer.from(params.data);
+        if (params.taglen <= 0 || data.length < 32 + params.taglen) {
+            throw new Error("Wrong message security tag");
+        }
         const tag = data.slice(data.length - params.taglen);
         data = data.slice(0, data.length - params.taglen);
         const rTag = Buffer.from(await this.hmacSha256(kem.kM, data)).slice(0, params.taglen);
-        if (!tag.equals(rTag)) {
+        if (!Utils.timingSafeEqual(tag, rTag)) {
             throw new Error("Wrong message security tag");
         }
         const iv = data.slice(0, 16);
@@ -318,6 +365,31 @@ export class EmCrypto {
 
 
 
+    private async keyCacheConfigure(params: Types.KeyCacheConfigure_PARAMS): Promise<ArrayBuffer> {
+        assertArgsValid(params, Types.KeyCacheConfigure_PARAMS);
+        assertIsNumber(params.capacity);
+        keyCache.setCapacity(params.capacity);
+        return new ArrayBuffer(0);
+    }
+
+    private async keyCacheClear(params: Types.KeyCacheClear_PARAMS): Promise<ArrayBuffer> {
+        assertArgsValid(params, Types.KeyCacheClear_PARAMS);
+        keyCache.clear();
+        kemCache.clear();
+        return new ArrayBuffer(0);
+    }
+
+    // Returns Float64 [hits, misses, evictions, size, capacity]
+    private async keyCacheStats(params: Types.KeyCacheStats_PARAMS): Promise<ArrayBuffer> {
+        assertArgsValid(params, Types.KeyCacheStats_PARAMS);
+        assertIsNumber(params.reset);
+        const stats = keyCache.getStats();
+        if (params.reset) {
+            keyCache.resetStats();
+        }
+        return new Float64Array([stats.hits, stats.misses, stats.evictions, stats.size, stats.capacity]).buffer;
+    }
+
     private fillWithZeroesTo32(buffer: Buffer) {
         return buffer.length < 32 ? Buffer.concat([Buffer.alloc(32 - buffer.length).fill(0), buffer]) : buffer;
     }
@@ -407,11 +479,14 @@ export class EmCrypto {
         assertIsUint8Array(params.data);
         assertIsUint8Array(params.r);
         assertIsUint8Array(params.s);
+        if (params.r.length > 32 || params.s.length > 32) {
+            return false;
+        }
         const buffer = Buffer.alloc(65);
         buffer.writeUInt8(27, 0);
-        Buffer.from(params.r).copy(buffer, 1);
-        Buffer.from(params.s).copy(buffer, 33);
-        return this.eccVerify({publicKey: params.publicKey, data: buffer, signature: params.data});
+        Buffer.from(params.r).copy(buffer, 33 - params.r.length);
+        Buffer.from(params.s).copy(buffer, 65 - params.s.length);
+        return this.eccVerify({publicKey: params.publicKey, data: params.data, signature: buffer});
     }
 
     private async eccDerive(params: Types.Derive_PARAMS) {
@@ -0,0 +1,60 @@
+/*!
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+const crypto = require('crypto');
+
+/**
+ * LRU cache of aes256CbcHmac256 key expansion results (kE || kM), so the kdf runs once per key.
+ * Entries are keyed by a salted SHA-256 fingerprint of the key and zeroed on eviction; callers
+ * always get copies, so zeroing never touches a buffer still in use.
+ */
+export class KemCache {
+    static DEFAULT_CAPACITY = 64;
+
+    private entries = new Map<string, Promise<Buffer>>();
+    private salt = globalThis.crypto.getRandomValues(new Uint8Array(16));
+
+    constructor(private capacity: number = KemCache.DEFAULT_CAPACITY) {}
+
+    async get(key: Uint8Array, info: string, derive: () => Promise<Buffer>): Promise<Buffer> {
+        if (this.capacity <= 0) {
+            return derive();
+        }
+        const id = `${info}:${crypto.createHash("sha256").update(this.salt).update(Buffer.from(key)).digest("base64")}`;
+        let cached = this.entries.get(id);
+        if (cached) {
+            this.entries.delete(id);
+        } else {
+            // The pending promise is cached too, so concurrent chunks with one key share a single kdf run
+            cached = derive();
+            cached.catch(() => this.entries.delete(id));
+        }
+        this.entries.set(id, cached);
+        this.evict();
+        return Buffer.from(await cached);
+    }
+
+    clear() {
+        this.shrink(0);
+    }
+
+    private evict() {
+        this.shrink(this.capacity);
+    }
+
+    private shrink(capacity: number) {
+        while (this.entries.size > capacity) {
+            const id = this.entries.keys().next().value;
+            this.entries.get(id).then(kem => kem.fill(0), () => {});
+            this.entries.delete(id);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*!
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+const {subtle} = globalThis.crypto;
+const crypto = require('crypto');
+
+export interface KeyCacheStats {
+    hits: number;
+    misses: number;
+    evictions: number;
+    size: number;
+    capacity: number;
+}
+
+/**
+ * LRU cache of imported WebCrypto keys, so a key used for many chunks is imported once.
+ * Entries are keyed by a salted SHA-256 fingerprint of the raw key, never by the key itself.
+ */
+export class KeyCache {
+    static DEFAULT_CAPACITY = 256;
+
+    private entries = new Map<string, Promise<CryptoKey>>();
+    private salt = globalThis.crypto.getRandomValues(new Uint8Array(16));
+    private hits = 0;
+    private misses = 0;
+    private evictions = 0;
+
+    constructor(private capacity: number = KeyCache.DEFAULT_CAPACITY) {}
+
+    async importKey(rawKey: Uint8Array, algorithm: string | HmacImportParams, usages: KeyUsage[]): Promise<CryptoKey> {
+        if (this.capacity <= 0) {
+            ++this.misses;
+            return subtle.importKey("raw", new Uint8Array(rawKey), algorithm, false, usages);
+        }
+        const id = this.fingerprint(rawKey, algorithm, usages);
+        const cached = this.entries.get(id);
+        if (cached) {
+            ++this.hits;
+            this.entries.delete(id);
+            this.entries.set(id, cached);
+            return cached;
+        }
+        ++this.misses;
+        // The pending promise is cached too, so concurrent calls with one key share a single import
+        const imported = subtle.importKey("raw", new Uint8Array(rawKey), algorithm, false, usages);
+        this.entries.set(id, imported);
+        imported.catch(() => this.entries.delete(id));
+        this.evict();
+        return imported;
+    }
+
+    setCapacity(capacity: number) {
+        this.capacity = Math.max(0, Math.floor(capacity));
+        this.evict();
+    }
+
+    clear() {
+        this.entries.clear();
+    }
+
+    resetStats() {
+        this.hits = 0;
+        this.misses = 0;
+        this.evictions = 0;
+    }
+
+    getStats(): KeyCacheStats {
+        return {
+            hits: this.hits,
+            misses: this.misses,
+            evictions: this.evictions,
+            size: this.entries.size,
+            capacity: this.capacity
+        };
+    }
+
+    private evict() {
+        while (this.entries.size > this.capacity) {
+            this.entries.delete(this.entries.keys().next().value);
+            ++this.evictions;
+        }
+    }
+
+    private fingerprint(rawKey: Uint8Array, algorithm: string | HmacImportParams, usages: KeyUsage[]): string {
+        const name = typeof algorithm === "string" ? algorithm : `${algorithm.name}/${algorithm.hash}`;
+        const digest = crypto.createHash("sha256").update(this.salt).update(Buffer.from(rawKey)).digest("base64");
+        return `${name}:${usages.join(",")}:${digest}`;
+    }
+}
@@ -72,6 +72,32 @@ export class Aes256CbcPkcs7Decrypt_PARAMS {
   taglen: number = 0;
 }
 
+export class Aes256GcmEncrypt_PARAMS {
+  data: Uint8Array;
+  key: Uint8Array;
+  iv: Uint8Array;
+  aad: Uint8Array;
+}
+
+export class Aes256GcmDecrypt_PARAMS {
+  data: Uint8Array;
+  key: Uint8Array;
+  iv: Uint8Array;
+  aad: Uint8Array;
+  tag: Uint8Array;
+}
+
+export class KeyCacheConfigure_PARAMS {
+  capacity: number = 0;
+}
+
+export class KeyCacheClear_PARAMS {
+}
+
+export class KeyCacheStats_PARAMS {
+  reset: number = 0;
+}
+
 export class FromPublicOrPrivateKey_PARAMS {
   key: Uint8Array;
 }
@@ -15,4 +15,16 @@ export function toArrayBuffer(buffer : Buffer) {
  
  export function toBuffer(byteArray : ArrayBuffer) {
     return Buffer.from(byteArray);
- }
\ No newline at end of file
+ }
+
+ // Constant-time comparison, for MAC tags.
+ export function timingSafeEqual(a: Uint8Array, b: Uint8Array): boolean {
+    if (a.length !== b.length) {
+        return false;
+    }
+    let diff = 0;
+    for (let i = 0; i < a.length; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff === 0;
+ }
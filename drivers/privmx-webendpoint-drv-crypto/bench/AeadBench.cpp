@@ -0,0 +1,107 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// AES-256-GCM vs the aes256CbcHmac256 construction (KEM via the SHA-256 kdf, AES-256-CBC over
+// 16 zero bytes || data, HMAC-SHA256 tag), both natively and through WebCrypto. The WebCrypto
+// CBC+HMAC variant issues the same calls as the JS driver, key imports included.
+
+#include <string.h>
+
+#include <privmx/drv/AesImpl.hpp>
+#include <privmx/drv/CbcHmacImpl.hpp>
+#include <privmx/drv/GcmImpl.hpp>
+#include <privmx/drv/HmacImpl.hpp>
+
+#include "Bench.hpp"
+
+// clang-format off
+
+EM_ASYNC_JS(double, webCryptoGcmUs, (const char* key, const char* iv, const char* data, int len, double minMs), {
+    const rawKey = HEAPU8.slice(key, key + 32);
+    const params = {name: "AES-GCM", iv: HEAPU8.slice(iv, iv + 12), additionalData: new Uint8Array(0)};
+    const input = HEAPU8.slice(data, data + len);
+    const run = async () => {
+        const cryptoKey = await crypto.subtle.importKey("raw", rawKey, "AES-GCM", false, ["encrypt"]);
+        return crypto.subtle.encrypt(params, cryptoKey, input);
+    };
+    await run();
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        await run();
+        ++iterations;
+    } while (performance.now() - start < minMs);
+    return (performance.now() - start) * 1000 / iterations;
+});
+
+EM_ASYNC_JS(double, webCryptoCbcHmacUs, (const char* key, const char* iv, const char* data, int len, double minMs), {
+    const subtle = crypto.subtle;
+    const rawKey = HEAPU8.slice(key, key + 32);
+    const iv16 = HEAPU8.slice(iv, iv + 16);
+    const input = HEAPU8.slice(data, data + len);
+    const hmac = async (k, d) => {
+        const hmacKey = await subtle.importKey("raw", k, {name: "HMAC", hash: "SHA-256"}, false, ["sign"]);
+        return new Uint8Array(await subtle.sign("HMAC", hmacKey, d));
+    };
+    const label = new TextEncoder().encode("key expansion");
+    const seed = new Uint8Array(label.length + 5);
+    seed.set(label);
+    new DataView(seed.buffer).setUint32(label.length + 1, 64);
+    const run = async () => {
+        const kem = new Uint8Array(64);
+        let k = new Uint8Array(0);
+        for (let i = 1; i <= 2; ++i) {
+            const block = new Uint8Array(k.length + 4 + seed.length);
+            block.set(k);
+            new DataView(block.buffer).setUint32(k.length, i);
+            block.set(seed, k.length + 4);
+            k = await hmac(rawKey, block);
+            kem.set(k, 32 * (i - 1));
+        }
+        const plain = new Uint8Array(16 + input.length);
+        plain.set(input, 16);
+        const aesKey = await subtle.importKey("raw", kem.slice(0, 32), "AES-CBC", true, ["encrypt"]);
+        const cipher = new Uint8Array(await subtle.encrypt({name: "AES-CBC", iv: iv16}, aesKey, plain));
+        return hmac(kem.slice(32), cipher);
+    };
+    await run();
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        await run();
+        ++iterations;
+    } while (performance.now() - start < minMs);
+    return (performance.now() - start) * 1000 / iterations;
+});
+
+// clang-format on
+
+int main() {
+    std::string key = bench::data(AesImpl::KEY_SIZE, 0x11);
+    std::string iv = bench::data(AesImpl::BLOCK_SIZE, 0x22);
+
+    bench::printHeader("encrypt, MB/s", {"native gcm", "native cbc+hmac", "webcrypto gcm", "webcrypto cbc+hmac"});
+    for (std::size_t len : bench::sizes()) {
+        std::string input = bench::data(len);
+        double gcmUs = bench::measureUs([&] {
+            std::string tag;
+            GcmImpl(key.data()).encrypt(iv.data(), nullptr, 0, input.data(), input.size(), tag);
+        });
+        double cbcHmacUs = bench::measureUs([&] {
+            CbcHmacImpl(key.data(), key.size()).encrypt(iv.data(), input.data(), input.size(), 32);
+        });
+        double jsGcmUs = webCryptoGcmUs(key.data(), iv.data(), input.data(), input.size(), 200);
+        double jsCbcHmacUs = webCryptoCbcHmacUs(key.data(), iv.data(), input.data(), input.size(), 200);
+        bench::printRow(len, {bench::mbPerSec(len, gcmUs), bench::mbPerSec(len, cbcHmacUs),
+                              bench::mbPerSec(len, jsGcmUs), bench::mbPerSec(len, jsCbcHmacUs)});
+    }
+    return 0;
+}
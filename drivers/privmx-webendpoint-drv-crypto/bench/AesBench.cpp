@@ -0,0 +1,80 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Native bitsliced AES-256-CBC vs WebCrypto AES-CBC, per input size. The key is imported once here
+// while the JS driver imports it on every call, so the WebCrypto timings are a lower bound.
+
+#include <privmx/drv/AesImpl.hpp>
+
+#include "Bench.hpp"
+
+// clang-format off
+
+EM_ASYNC_JS(double, webCryptoAesCbcUs, (int decrypt, const char* key, const char* iv, const char* data, int len,
+                                        double minMs), {
+    const rawKey = HEAPU8.slice(key, key + 32);
+    const params = {name: "AES-CBC", iv: HEAPU8.slice(iv, iv + 16)};
+    const cryptoKey = await crypto.subtle.importKey("raw", rawKey, "AES-CBC", false, ["encrypt", "decrypt"]);
+    let input = HEAPU8.slice(data, data + len);
+    if (decrypt) {
+        input = new Uint8Array(await crypto.subtle.encrypt(params, cryptoKey, input));
+    }
+    const run = () => decrypt ? crypto.subtle.decrypt(params, cryptoKey, input)
+                              : crypto.subtle.encrypt(params, cryptoKey, input);
+    await run();
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        await run();
+        ++iterations;
+    } while (performance.now() - start < minMs);
+    return (performance.now() - start) * 1000 / iterations;
+});
+
+// clang-format on
+
+int main() {
+    std::string key = bench::data(AesImpl::KEY_SIZE, 0x11);
+    std::string iv = bench::data(AesImpl::BLOCK_SIZE, 0x22);
+    AesImpl aes(key.data());
+
+    for (int decrypt = 0; decrypt < 2; ++decrypt) {
+        bench::printHeader(decrypt ? "AES-256-CBC decrypt" : "AES-256-CBC encrypt",
+                           {"native us/op", "native MB/s", "webcrypto us/op", "webcrypto MB/s"});
+        std::size_t crossover = 0;
+        for (std::size_t len : bench::sizes()) {
+            std::string input = bench::data(len);
+            if (decrypt) {
+                input = aes.encrypt(AesImpl::Mode::CBC_PKCS7, iv.data(), input.data(), input.size());
+            }
+            double nativeUs = bench::measureUs([&] {
+                if (decrypt) {
+                    aes.decrypt(AesImpl::Mode::CBC_PKCS7, iv.data(), input.data(), input.size());
+                } else {
+                    aes.encrypt(AesImpl::Mode::CBC_PKCS7, iv.data(), input.data(), input.size());
+                }
+            });
+            // the WebCrypto run encrypts the plaintext itself when measuring decryption
+            std::string plain = bench::data(len);
+            double jsUs = webCryptoAesCbcUs(decrypt, key.data(), iv.data(), plain.data(), plain.size(), 200);
+            bench::printRow(len, {nativeUs, bench::mbPerSec(len, nativeUs), jsUs, bench::mbPerSec(len, jsUs)});
+            if (crossover == 0 && jsUs < nativeUs) {
+                crossover = len;
+            }
+        }
+        if (crossover) {
+            printf("crossover: WebCrypto faster from %zu bytes\n", crossover);
+        } else {
+            printf("crossover: native faster at all measured sizes\n");
+        }
+    }
+    return 0;
+}
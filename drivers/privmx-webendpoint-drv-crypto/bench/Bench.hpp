@@ -0,0 +1,70 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_BENCH_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_BENCH_HPP_
+
+#include <emscripten.h>
+#include <stdio.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline const std::vector<std::size_t>& sizes() {
+    static const std::vector<std::size_t> sizes = {32, 256, 1024, 4096, 16384, 65536, 262144, 1048576};
+    return sizes;
+}
+
+inline std::string data(std::size_t len, unsigned char seed = 0x5a) {
+    std::string result(len, '\0');
+    for (std::size_t i = 0; i < len; ++i) {
+        result[i] = (char)(i * 131 + seed);
+    }
+    return result;
+}
+
+// Repeats fn for at least minMs and returns the mean time of a single call in microseconds.
+inline double measureUs(const std::function<void()>& fn, double minMs = 200) {
+    fn();  // warm-up
+    std::size_t iterations = 0;
+    double start = emscripten_get_now();
+    double elapsed = 0;
+    do {
+        fn();
+        ++iterations;
+        elapsed = emscripten_get_now() - start;
+    } while (elapsed < minMs);
+    return elapsed * 1000 / iterations;
+}
+
+inline double mbPerSec(std::size_t len, double us) {
+    return us > 0 ? len / us : 0;
+}
+
+inline void printHeader(const char* title, const std::vector<std::string>& columns) {
+    printf("\n%s\n%10s", title, "bytes");
+    for (const auto& column : columns) printf(" %16s", column.c_str());
+    printf("\n");
+}
+
+inline void printRow(std::size_t len, const std::vector<double>& values) {
+    printf("%10zu", len);
+    for (double value : values) printf(" %16.2f", value);
+    printf("\n");
+}
+
+}  // namespace bench
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_BENCH_HPP_
@@ -0,0 +1,192 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Decrypt workload of one listMessages page: 100 messages of 200 B - 4 KiB under one thread key, each
+// needing the aes256CbcHmac256 steps (KEM via two kdf HMACs, HMAC-SHA256 tag check, AES-256-CBC
+// decrypt). Drives the C API: one privmxDrvCrypto_hmac/aesDecrypt call per primitive, against one
+// privmxDrvCrypto_hmacBatch/aesDecryptBatch call per step for the whole page. privmxDrvCrypto_setDispatch
+// pins both to the native path, then to the JS path (WebCrypto through em_crypto.js on the crypto thread).
+
+#include <stdlib.h>
+
+#include <privmx/drv/crypto.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+
+namespace {
+
+const std::size_t PAGE_SIZE = 100;
+const char* const HMAC_CONFIG = "SHA256";
+const char* const AES_CONFIG = "AES-256-CBC";
+
+struct Message {
+    std::string iv;
+    std::string cipher;
+    std::string tag;
+};
+
+std::string kdfBlock(const std::string& k, unsigned char i) {
+    const char label[] = "key expansion";
+    std::string block = k;
+    block.append("\0\0\0", 3);
+    block.push_back((char)i);
+    block.append(label, sizeof(label) - 1);
+    block.append("\0\0\0\0\x40", 5);
+    return block;
+}
+
+// Copies and releases a driver output buffer.
+std::string take(int status, char* out, unsigned int outlen) {
+    if (status != 0 || !out) {
+        throw std::runtime_error("Crypto call failed");
+    }
+    std::string result(out, outlen);
+    privmxDrvCrypto_freeMem(out);
+    return result;
+}
+
+std::string hmac(const std::string& key, const std::string& data) {
+    char* out = nullptr;
+    unsigned int outlen = 0;
+    int status =
+        privmxDrvCrypto_hmac(key.data(), key.size(), data.data(), data.size(), HMAC_CONFIG, &out, &outlen);
+    return take(status, out, outlen);
+}
+
+std::string aesDecrypt(const std::string& key, const std::string& iv, const std::string& data) {
+    char* out = nullptr;
+    unsigned int outlen = 0;
+    int status = privmxDrvCrypto_aesDecrypt(key.data(), iv.data(), data.data(), data.size(), AES_CONFIG, &out, &outlen);
+    return take(status, out, outlen);
+}
+
+// Copies and releases the output buffers of a batch call.
+std::vector<std::string> takeAll(int status, const std::vector<char*>& outs, const std::vector<unsigned int>& outlens) {
+    std::vector<std::string> results;
+    for (std::size_t i = 0; i < outs.size(); ++i) {
+        if (outs[i]) {
+            results.emplace_back(outs[i], outlens[i]);
+            privmxDrvCrypto_freeMem(outs[i]);
+        }
+    }
+    if (status != 0 || results.size() != outs.size()) {
+        throw std::runtime_error("Crypto batch call failed");
+    }
+    return results;
+}
+
+std::vector<std::string> hmacBatch(const std::vector<std::string>& keys, const std::vector<std::string>& data) {
+    std::size_t count = data.size();
+    std::vector<const char*> keyPtrs(count), dataPtrs(count);
+    std::vector<unsigned int> keylens(count), datalens(count), outlens(count);
+    std::vector<char*> outs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keyPtrs[i] = keys[i].data();
+        keylens[i] = keys[i].size();
+        dataPtrs[i] = data[i].data();
+        datalens[i] = data[i].size();
+    }
+    int status = privmxDrvCrypto_hmacBatch(keyPtrs.data(), keylens.data(), dataPtrs.data(), datalens.data(), count,
+                                           HMAC_CONFIG, outs.data(), outlens.data());
+    return takeAll(status, outs, outlens);
+}
+
+std::vector<std::string> aesDecryptBatch(const std::vector<std::string>& keys, const std::vector<std::string>& ivs,
+                                         const std::vector<std::string>& data) {
+    std::size_t count = data.size();
+    std::vector<const char*> keyPtrs(count), ivPtrs(count), dataPtrs(count);
+    std::vector<unsigned int> datalens(count), outlens(count);
+    std::vector<char*> outs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keyPtrs[i] = keys[i].data();
+        ivPtrs[i] = ivs[i].data();
+        dataPtrs[i] = data[i].data();
+        datalens[i] = data[i].size();
+    }
+    int status = privmxDrvCrypto_aesDecryptBatch(keyPtrs.data(), ivPtrs.data(), dataPtrs.data(), datalens.data(),
+                                                 count, AES_CONFIG, outs.data(), outlens.data());
+    return takeAll(status, outs, outlens);
+}
+
+// Every message on its own, one entry point call per primitive.
+void decryptPerCall(const std::string& key, const std::vector<Message>& messages) {
+    for (const Message& message : messages) {
+        std::string k1 = hmac(key, kdfBlock("", 1));
+        std::string k2 = hmac(key, kdfBlock(k1, 2));
+        if (hmac(k2, message.cipher) != message.tag) abort();
+        aesDecrypt(k1, message.iv, message.cipher);
+    }
+}
+
+// The whole page step by step, one batch call per step.
+void decryptBatched(const std::string& key, const std::vector<std::string>& ivs,
+                    const std::vector<std::string>& ciphers, const std::vector<std::string>& tags) {
+    std::vector<std::string> keys(ciphers.size(), key);
+    std::vector<std::string> blocks(ciphers.size(), kdfBlock("", 1));
+    std::vector<std::string> k1 = hmacBatch(keys, blocks);
+    for (std::size_t i = 0; i < blocks.size(); ++i) blocks[i] = kdfBlock(k1[i], 2);
+    std::vector<std::string> k2 = hmacBatch(keys, blocks);
+    if (hmacBatch(k2, ciphers) != tags) abort();
+    aesDecryptBatch(k1, ivs, ciphers);
+}
+
+void setDispatch(int mode) {
+    privmxDrvCrypto_setDispatch("hmac", mode, 0);
+    privmxDrvCrypto_setDispatch("aes", mode, 0);
+}
+
+}  // namespace
+
+int main() {
+    setDispatch(1);
+    std::string key = bench::data(32, 0x11);
+    std::string k1 = hmac(key, kdfBlock("", 1));
+    std::string k2 = hmac(key, kdfBlock(k1, 2));
+
+    std::vector<Message> messages;
+    std::vector<std::string> ivs, ciphers, tags;
+    std::size_t pageBytes = 0;
+    for (std::size_t i = 0; i < PAGE_SIZE; ++i) {
+        std::size_t len = 200 + (i * 7919) % 3900;
+        Message message;
+        message.iv = bench::data(16, (unsigned char)i);
+        std::string plain = bench::data(len, (unsigned char)(i * 3));
+        char* out = nullptr;
+        unsigned int outlen = 0;
+        int status = privmxDrvCrypto_aesEncrypt(k1.data(), message.iv.data(), plain.data(), plain.size(), AES_CONFIG,
+                                                &out, &outlen);
+        message.cipher = take(status, out, outlen);
+        message.tag = hmac(k2, message.cipher);
+        ivs.push_back(message.iv);
+        ciphers.push_back(message.cipher);
+        tags.push_back(message.tag);
+        pageBytes += message.cipher.size();
+        messages.push_back(message);
+    }
+
+    printf("\nlistMessages page (%zu messages, %zu bytes), ms per page\n", PAGE_SIZE, pageBytes);
+    printf("%10s %14s %14s %10s\n", "path", "per call", "batch", "speedup");
+    struct Path {
+        const char* name;
+        int mode;
+        double minMs;
+    };
+    for (const Path& path : {Path{"native", 1, 200}, Path{"webcrypto", 2, 500}}) {
+        setDispatch(path.mode);
+        double perCallUs = bench::measureUs([&] { decryptPerCall(key, messages); }, path.minMs);
+        double batchUs = bench::measureUs([&] { decryptBatched(key, ivs, ciphers, tags); }, path.minMs);
+        printf("%10s %14.3f %14.3f %10.2f\n", path.name, perCallUs / 1000, batchUs / 1000, perCallUs / batchUs);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Native digests vs WebCrypto subtle.digest, per input size. Prints the smallest size at which
+// WebCrypto is faster - a lower bound for the "md" dispatch threshold, since the real JS path also
+// pays the proxy to the crypto thread and the result copies.
+
+#include <privmx/drv/HashImpl.hpp>
+
+#include "Bench.hpp"
+
+// clang-format off
+
+EM_ASYNC_JS(double, webCryptoDigestUs, (const char* alg_str, const char* data, int len, double minMs), {
+    const alg = UTF8ToString(alg_str);
+    const input = HEAPU8.slice(data, data + len);
+    await crypto.subtle.digest(alg, input);
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        await crypto.subtle.digest(alg, input);
+        ++iterations;
+    } while (performance.now() - start < minMs);
+    return (performance.now() - start) * 1000 / iterations;
+});
+
+// clang-format on
+
+int main() {
+    struct Case {
+        const char* config;
+        const char* webCrypto;
+    };
+    const Case cases[] = {{"SHA1", "SHA-1"}, {"SHA256", "SHA-256"}, {"SHA512", "SHA-512"}, {"RIPEMD160", nullptr}};
+
+    for (const Case& c : cases) {
+        HashImpl::Algorithm algorithm = HashImpl::fromConfig(c.config);
+        bench::printHeader(c.config, {"native us/op", "native MB/s", "webcrypto us/op", "webcrypto MB/s"});
+        std::size_t crossover = 0;
+        for (std::size_t len : bench::sizes()) {
+            std::string input = bench::data(len);
+            double nativeUs = bench::measureUs([&] { HashImpl::digest(algorithm, input.data(), input.size()); });
+            double jsUs = c.webCrypto ? webCryptoDigestUs(c.webCrypto, input.data(), input.size(), 200) : 0;
+            bench::printRow(len, {nativeUs, bench::mbPerSec(len, nativeUs), jsUs, bench::mbPerSec(len, jsUs)});
+            if (c.webCrypto && crossover == 0 && jsUs < nativeUs) {
+                crossover = len;
+            }
+        }
+        if (!c.webCrypto) {
+            printf("crossover: none (no WebCrypto backend, always native)\n");
+        } else if (crossover) {
+            printf("crossover: WebCrypto faster from %zu bytes\n", crossover);
+        } else {
+            printf("crossover: native faster at all measured sizes\n");
+        }
+    }
+    return 0;
+}
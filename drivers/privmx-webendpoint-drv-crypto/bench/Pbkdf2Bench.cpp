@@ -0,0 +1,124 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// PBKDF2 at realistic iteration counts: BIP-39 mnemonicToSeed (HMAC-SHA512, 2048) and password
+// logins (OWASP: HMAC-SHA256 600000, HMAC-SHA512 210000). WebCrypto is faster per derivation, but it
+// runs on the single crypto thread; the native one runs on the calling worker, in parallel with others.
+// Drives privmxDrvCrypto_pbkdf2 pinned to each path, after checking known answers on both.
+
+#include <privmx/drv/crypto.h>
+#include <stdexcept>
+#include <string>
+
+#include "Bench.hpp"
+
+namespace {
+
+std::string pbkdf2(const std::string& password, const std::string& salt, int rounds, unsigned int length,
+                   const char* hash) {
+    char* out = nullptr;
+    unsigned int outlen = 0;
+    int status = privmxDrvCrypto_pbkdf2(password.data(), password.size(), salt.data(), salt.size(), rounds, length,
+                                        hash, &out, &outlen);
+    if (status != 0 || !out) {
+        throw std::runtime_error("pbkdf2 failed");
+    }
+    std::string result(out, outlen);
+    privmxDrvCrypto_freeMem(out);
+    return result;
+}
+
+std::string toHex(const std::string& data) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : data) {
+        hex.push_back(digits[c >> 4]);
+        hex.push_back(digits[c & 15]);
+    }
+    return hex;
+}
+
+double jsCalls() {
+    double stats[4];
+    privmxDrvCrypto_getDispatchStats("pbkdf2", stats);
+    return stats[2];
+}
+
+// Expected values from Python's hashlib.pbkdf2_hmac. The JS driver gets password and salt as JS strings,
+// so the invalid bytes of the second salt count as U+FFFD (EF BF BD), on either path.
+void checkKnownAnswers() {
+    struct Case {
+        std::string password;
+        std::string salt;
+        int rounds;
+        unsigned int length;
+        const char* hash;
+        const char* expected;
+        bool native;
+    };
+    const Case cases[] = {
+        {"za\xc5\xbc\xc3\xb3\xc5\x82\xc4\x87 g\xc4\x99\xc5\x9bl\xc4\x85 ja\xc5\xba\xc5\x84", "mnemonic", 2048, 64,
+         "sha512",
+         "338bdcbb91b3bd03efb7d2afa165266d879302be0883267ac134099cc6228668"
+         "db01d2ad67cabf406e8b03d58e0500279564ec4fcdd2f81064c5fb27b7820044",
+         true},
+        {"correct horse battery staple", "privmx-salt-\xff\xfe-caf\xe9-2024", 1000, 32, "sha256",
+         "382934a55f1b1844c8872d55da633e3ae9a9b5a2b516133e5a28fcf3112fd7af", false},
+    };
+    for (const Case& c : cases) {
+        for (int mode : {1, 2}) {
+            privmxDrvCrypto_setDispatch("pbkdf2", mode, 0);
+            double before = jsCalls();
+            std::string result = toHex(pbkdf2(c.password, c.salt, c.rounds, c.length, c.hash));
+            if (result != c.expected) {
+                throw std::runtime_error("pbkdf2 known answer mismatch in mode " + std::to_string(mode) + ": " +
+                                         result);
+            }
+            // Native mode derives in place only what it derives like JS does
+            bool native = jsCalls() == before;
+            if (native != (mode == 1 && c.native)) {
+                throw std::runtime_error("pbkdf2 took the wrong path in mode " + std::to_string(mode));
+            }
+        }
+    }
+    printf("pbkdf2 known answers match on both paths\n");
+}
+
+}  // namespace
+
+int main() {
+    checkKnownAnswers();
+
+    struct Case {
+        const char* hash;
+        int rounds;
+        unsigned int length;
+    };
+    const Case cases[] = {
+        {"sha512", 2048, 64},
+        {"sha256", 100000, 32},
+        {"sha512", 210000, 64},
+        {"sha256", 600000, 32},
+    };
+    const std::string password = "correct horse battery staple";
+    const std::string salt = "mnemonic";
+
+    printf("\n%8s %10s %16s %16s\n", "hash", "rounds", "native ms", "webcrypto ms");
+    for (const Case& c : cases) {
+        double us[2];
+        for (int mode : {1, 2}) {
+            privmxDrvCrypto_setDispatch("pbkdf2", mode, 0);
+            us[mode - 1] = bench::measureUs([&] { pbkdf2(password, salt, c.rounds, c.length, c.hash); }, 1);
+        }
+        printf("%8s %10d %16.2f %16.2f\n", c.hash, c.rounds, us[0] / 1000, us[1] / 1000);
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// IV-heavy workload: time per randomBytes request of IV / key sizes, served from the per-thread pool,
+// by one getentropy() per request, and by an awaited crypto.getRandomValues per request - a lower
+// bound for the previous path, which also proxied every request to the crypto thread.
+
+#include <unistd.h>
+
+#include <privmx/drv/RandomPool.hpp>
+
+#include "Bench.hpp"
+
+// clang-format off
+
+EM_ASYNC_JS(double, awaitedRandomUs, (int len, double minMs), {
+    const next = async () => crypto.getRandomValues(new Uint8Array(len));
+    await next();
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        await next();
+        ++iterations;
+    } while (performance.now() - start < minMs);
+    return (performance.now() - start) * 1000 / iterations;
+});
+
+// clang-format on
+
+int main() {
+    const std::size_t lens[] = {12, 16, 32, 64, 256};
+    char buf[256];
+
+    bench::printHeader("us per request", {"pool", "getentropy", "awaited js"});
+    for (std::size_t len : lens) {
+        double poolUs = bench::measureUs([&] { RandomPool::fill(buf, len); });
+        double entropyUs = bench::measureUs([&] { getentropy(buf, len); });
+        double jsUs = awaitedRandomUs(len, 200);
+        bench::printRow(len, {poolUs, entropyUs, jsUs});
+    }
+    RandomPool::Stats stats = RandomPool::getStats();
+    printf("pooled calls %llu, refills %llu\n", (unsigned long long)stats.pooledCalls,
+           (unsigned long long)stats.refills);
+    return 0;
+}
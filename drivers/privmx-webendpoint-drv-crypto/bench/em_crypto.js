@@ -0,0 +1,52 @@
+/*!
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Stand-in for drv-context's EmCrypto in node benchmarks (--pre-js, so every thread gets one). Implements
+// only the methods the benchmarked entry points call, on WebCrypto with imported keys cached like KeyCache.
+(() => {
+    if (typeof self === "undefined") {
+        globalThis.self = globalThis;
+    }
+    const subtle = globalThis.crypto.subtle;
+    const keys = new Map();
+    const importKey = (raw, algorithm, usages) => {
+        const id = JSON.stringify(algorithm) + ":" + Buffer.from(raw).toString("hex");
+        if (!keys.has(id)) {
+            keys.set(id, subtle.importKey("raw", new Uint8Array(raw), algorithm, false, usages));
+        }
+        return keys.get(id);
+    };
+    const hashes = {sha1: "SHA-1", sha256: "SHA-256", sha512: "SHA-512"};
+    const methods = {
+        hmac: async (params) => {
+            const key = await importKey(params.key, {name: "HMAC", hash: hashes[params.engine]}, ["sign"]);
+            return subtle.sign("HMAC", key, new Uint8Array(params.data));
+        },
+        // Like EmCrypto, password and salt arrive as strings and are encoded as UTF-8
+        pbkdf2: async (params) => {
+            const key = await subtle.importKey("raw", Buffer.from(params.password, "utf-8"), "PBKDF2", false, ["deriveBits"]);
+            const salt = Buffer.from(params.salt, "utf-8");
+            return subtle.deriveBits({name: "PBKDF2", salt, iterations: params.rounds, hash: hashes[params.hash]}, key, params.length * 8);
+        },
+        aes256CbcPkcs7Decrypt: async (params) => {
+            const key = await importKey(params.key, "AES-CBC", ["encrypt", "decrypt"]);
+            return subtle.decrypt({name: "AES-CBC", iv: new Uint8Array(params.iv)}, key, new Uint8Array(params.data));
+        },
+    };
+    self.em_crypto = {
+        methodCaller: async (name, params) => {
+            if (!methods[name]) {
+                throw new Error(`Method '${name}' is not implemented.`);
+            }
+            return methods[name](params);
+        },
+    };
+})();
@@ -0,0 +1,80 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_AESIMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_AESIMPL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Native constant-time AES-256.
+ * Bitsliced implementation (no secret-dependent table lookups or branches) working on four
+ * blocks per pass; CBC encryption is sequential and uses one of the four lanes.
+ */
+class AesImpl {
+public:
+    enum class Mode { CBC_PKCS7, CBC_NOPAD, ECB_NOPAD };
+
+    class CbcStream;
+
+    static constexpr std::size_t KEY_SIZE = 32;
+    static constexpr std::size_t BLOCK_SIZE = 16;
+
+    static Mode fromConfig(const char* config);
+
+    explicit AesImpl(const char* key);
+    AesImpl(const AesImpl& obj) = default;
+    AesImpl& operator=(const AesImpl& obj) = default;
+    ~AesImpl();
+
+    std::string encrypt(Mode mode, const char* iv, const char* data, std::size_t datalen) const;
+    std::string decrypt(Mode mode, const char* iv, const char* data, std::size_t datalen) const;
+
+    // Raw block operations; in and out may alias.
+    void encryptBlocks(const unsigned char* in, unsigned char* out, std::size_t blocks) const;
+    void decryptBlocks(const unsigned char* in, unsigned char* out, std::size_t blocks) const;
+    void cbcEncrypt(unsigned char* iv, const unsigned char* in, unsigned char* out, std::size_t blocks) const;
+    void cbcDecrypt(unsigned char* iv, const unsigned char* in, unsigned char* out, std::size_t blocks) const;
+
+private:
+    static constexpr unsigned ROUNDS = 14;
+
+    uint64_t _skey[(ROUNDS + 1) * 8];
+};
+
+/**
+ * Incremental CBC_PKCS7 / CBC_NOPAD encryption or decryption of one message fed in chunks of any size.
+ * update() outputs whole blocks only. Decryption holds the last block back until finish(), which
+ * handles the padding exactly like AesImpl::encrypt() / decrypt() do.
+ */
+class AesImpl::CbcStream {
+public:
+    CbcStream(const char* key, Mode mode, bool encrypt, const char* iv);
+    ~CbcStream();
+
+    std::string update(const char* data, std::size_t datalen);
+    // Throws on invalid padding or, for CBC_NOPAD encryption, on a partial last block.
+    std::string finish();
+
+private:
+    void process(const unsigned char* in, unsigned char* out, std::size_t blocks);
+
+    AesImpl _aes;
+    Mode _mode;
+    bool _encrypt;
+    unsigned char _chain[BLOCK_SIZE];
+    unsigned char _buffer[BLOCK_SIZE];
+    std::size_t _buffered = 0;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_AESIMPL_HPP_
@@ -0,0 +1,56 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CBCHMACIMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CBCHMACIMPL_HPP_
+
+#include <cstddef>
+#include <privmx/drv/AesImpl.hpp>
+#include <privmx/drv/HmacImpl.hpp>
+#include <string>
+
+/**
+ * Native aes256CbcHmac256, byte-identical with the JS driver: the encryption and MAC keys come
+ * from the SHA-256 kdf ("key expansion"), data is encrypted with AES-256-CBC as 16 zero bytes || data
+ * (so the first cipher block doubles as the IV on decryption) and HMAC-SHA256 of the ciphertext,
+ * truncated to taglen bytes, is appended.
+ */
+class CbcHmacImpl {
+public:
+    static constexpr std::size_t MAX_TAG_SIZE = 32;
+    static constexpr std::size_t KEM_SIZE = AesImpl::KEY_SIZE + 32;
+
+    static bool isValidTagSize(std::size_t taglen);
+    // Writes kE || kM, the KEM_SIZE byte output of kdf(SHA-256, key, "key expansion"), to kem.
+    static void deriveKem(const char* key, std::size_t keylen, unsigned char* kem);
+
+    CbcHmacImpl(const char* key, std::size_t keylen);
+    // From KEM material already derived with deriveKem, e.g. cached by KemCache.
+    explicit CbcHmacImpl(const unsigned char* kem);
+
+    // Returns ciphertext || tag.
+    std::string encrypt(const char* iv, const char* data, std::size_t datalen, std::size_t taglen) const;
+    // Throws if the tag does not match; the ciphertext is not decrypted in that case.
+    std::string decrypt(const char* data, std::size_t datalen, std::size_t taglen) const;
+
+private:
+    // kE || kM, zeroed when it goes out of scope.
+    struct Kem {
+        Kem(const char* key, std::size_t keylen);
+        ~Kem();
+        unsigned char bytes[KEM_SIZE];
+    };
+
+    AesImpl _aes;
+    HmacImpl _mac;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CBCHMACIMPL_HPP_
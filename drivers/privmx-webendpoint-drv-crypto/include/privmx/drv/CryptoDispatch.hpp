@@ -0,0 +1,67 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CRYPTODISPATCH_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CRYPTODISPATCH_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Decides per operation whether a crypto call runs natively on the calling thread
+ * or is forwarded to the JS crypto thread (WebCrypto).
+ *
+ * In AUTO mode inputs shorter than the threshold run natively: the JS round trip
+ * (proxy to the crypto thread, promise, copies) dominates for small inputs, while
+ * WebCrypto wins on throughput for large ones. Default thresholds come from the
+ * drv-crypto microbenchmarks (see bench/).
+ */
+class CryptoDispatch {
+public:
+    enum class Op { MD = 0, HMAC, AES, AEAD, CBC_HMAC, PBKDF2, COUNT };
+    enum class Mode { AUTO = 0, NATIVE = 1, JS = 2 };
+
+    struct Stats {
+        uint64_t nativeCalls;
+        uint64_t nativeBytes;
+        uint64_t jsCalls;
+        uint64_t jsBytes;
+    };
+
+    static CryptoDispatch& getInstance();
+    static Op opFromName(const char* name);
+
+    // preferNative makes AUTO ignore the threshold, for algorithms without a WebCrypto backend.
+    bool useNative(Op op, std::size_t datalen, bool preferNative = false) const;
+    void configure(Op op, Mode mode, std::size_t threshold);
+
+    // Per-path counters, updated by the callers once the path was chosen.
+    void record(Op op, bool native, std::size_t datalen);
+    Stats getStats(Op op) const;
+    void resetStats();
+
+private:
+    CryptoDispatch();
+
+    struct Policy {
+        std::atomic<int> mode;
+        std::atomic<std::size_t> threshold;
+        std::atomic<uint64_t> nativeCalls{0};
+        std::atomic<uint64_t> nativeBytes{0};
+        std::atomic<uint64_t> jsCalls{0};
+        std::atomic<uint64_t> jsBytes{0};
+    };
+
+    Policy _policies[(int)Op::COUNT];
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_CRYPTODISPATCH_HPP_
@@ -0,0 +1,95 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_GCMIMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_GCMIMPL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <privmx/drv/AesImpl.hpp>
+#include <string>
+
+/**
+ * Native AES-256-GCM (NIST SP 800-38D) with a 96-bit IV.
+ * CTR runs on the bitsliced AesImpl and GHASH uses constant-time carry-less multiplication,
+ * so neither depends on table lookups.
+ */
+class GcmImpl {
+public:
+    static constexpr std::size_t IV_SIZE = 12;
+    static constexpr std::size_t TAG_SIZE = 16;
+
+    class Stream;
+
+    // Throws unless config is "AES-256-GCM".
+    static void checkConfig(const char* config);
+    // Tag lengths accepted by WebCrypto: 4, 8 and 12 to 16 bytes.
+    static bool isValidTagSize(std::size_t taglen);
+
+    explicit GcmImpl(const char* key);
+    ~GcmImpl();
+
+    // Returns the ciphertext and writes the TAG_SIZE byte tag to tag.
+    std::string encrypt(const char* iv, const char* aad, std::size_t aadlen, const char* data, std::size_t datalen,
+                        std::string& tag) const;
+    // Throws if the (possibly truncated) tag does not match; no plaintext is returned in that case.
+    std::string decrypt(const char* iv, const char* aad, std::size_t aadlen, const char* data, std::size_t datalen,
+                        const char* tag, std::size_t taglen) const;
+
+private:
+    struct Ghash {
+        uint64_t y0, y1;
+    };
+
+    void ghashUpdate(Ghash& state, const unsigned char* data, std::size_t datalen) const;
+    void ctr(const unsigned char* j0, const unsigned char* in, unsigned char* out, std::size_t datalen) const;
+    void computeTag(const unsigned char* j0, const char* aad, std::size_t aadlen, const unsigned char* cipher,
+                    std::size_t datalen, unsigned char* tag) const;
+    // Hashes the length block into state and masks the result with E(j0).
+    void finishTag(Ghash& state, const unsigned char* j0, std::size_t aadlen, std::size_t datalen,
+                   unsigned char* tag) const;
+
+    AesImpl _aes;
+    uint64_t _h0, _h1;
+};
+
+/**
+ * Incremental AES-256-GCM encryption or decryption of one message fed in chunks of any size.
+ * update() outputs whole blocks only, the rest comes from finish(). On decryption everything update()
+ * returned is unauthenticated until finish() succeeded, and must be discarded if it throws.
+ */
+class GcmImpl::Stream {
+public:
+    Stream(const char* key, bool encrypt, const char* iv, const char* aad, std::size_t aadlen);
+    ~Stream();
+
+    std::string update(const char* data, std::size_t datalen);
+    // Encryption: writes the TAG_SIZE byte tag to tag.
+    std::string finish(std::string& tag);
+    // Decryption: throws if the (possibly truncated) tag does not match; the final bytes are withheld then.
+    std::string finish(const char* tag, std::size_t taglen);
+
+private:
+    void process(const unsigned char* in, unsigned char* out, std::size_t datalen);
+
+    GcmImpl _gcm;
+    bool _encrypt;
+    unsigned char _j0[AesImpl::BLOCK_SIZE];
+    // Counter block of the last keystream block used.
+    unsigned char _counter[AesImpl::BLOCK_SIZE];
+    Ghash _ghash{0, 0};
+    std::size_t _aadlen;
+    std::size_t _datalen = 0;
+    unsigned char _buffer[AesImpl::BLOCK_SIZE];
+    std::size_t _buffered = 0;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_GCMIMPL_HPP_
@@ -0,0 +1,48 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HASHIMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HASHIMPL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Native (wasm) message digests: SHA-1, SHA-256, SHA-512 and RIPEMD-160.
+ * Instances are incremental (update/digest) and are not thread safe.
+ */
+class HashImpl {
+public:
+    using Ptr = std::unique_ptr<HashImpl>;
+
+    enum class Algorithm { SHA1, SHA256, SHA512, RIPEMD160 };
+
+    static Algorithm fromConfig(const char* config);
+    static HashImpl::Ptr create(Algorithm algorithm);
+    static std::string digest(Algorithm algorithm, const char* data, std::size_t datalen);
+    static std::size_t digestSize(Algorithm algorithm);
+
+    virtual ~HashImpl() = default;
+    virtual void update(const unsigned char* data, std::size_t datalen) = 0;
+    // Writes digestSize() bytes to out; the instance must not be updated afterwards.
+    virtual void digest(unsigned char* out) = 0;
+    virtual HashImpl::Ptr clone() const = 0;
+    // Copies the state of obj, which must use the same algorithm, without allocating.
+    virtual void restore(const HashImpl& obj) = 0;
+    virtual std::size_t digestSize() const = 0;
+    virtual std::size_t blockSize() const = 0;
+
+    std::string digest();
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HASHIMPL_HPP_
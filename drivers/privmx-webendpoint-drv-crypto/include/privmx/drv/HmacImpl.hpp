@@ -0,0 +1,45 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HMACIMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HMACIMPL_HPP_
+
+#include <privmx/drv/HashImpl.hpp>
+#include <string>
+
+/**
+ * Native HMAC (RFC 2104) over any HashImpl digest.
+ * Keyed inner/outer states are prepared once in the constructor, so one instance can be cloned
+ * cheaply for many messages under the same key.
+ */
+class HmacImpl {
+public:
+    static std::string compute(HashImpl::Algorithm algorithm, const char* key, std::size_t keylen, const char* data,
+                               std::size_t datalen);
+
+    HmacImpl(HashImpl::Algorithm algorithm, const char* key, std::size_t keylen);
+    HmacImpl(const HmacImpl& obj);
+    HmacImpl& operator=(const HmacImpl& obj);
+    // Same as assignment from an instance of the same algorithm, but without allocating.
+    void reset(const HmacImpl& obj);
+
+    void update(const char* data, std::size_t datalen);
+    // Writes digestSize() bytes to out; the instance must not be updated afterwards.
+    void digest(unsigned char* out);
+    std::string digest();
+    std::size_t digestSize() const;
+
+private:
+    HashImpl::Ptr _inner;
+    HashImpl::Ptr _outer;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_HMACIMPL_HPP_
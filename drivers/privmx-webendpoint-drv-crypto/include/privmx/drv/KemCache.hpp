@@ -0,0 +1,75 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_KEMCACHE_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_KEMCACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <privmx/drv/CbcHmacImpl.hpp>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Process-wide LRU cache of aes256CbcHmac256 key expansion (kE || kM), so a key that encrypts many
+ * chunks runs the kdf once. Entries are looked up by an HMAC-SHA256 fingerprint of the key under a
+ * random per-process salt, never by the key itself, and are zeroed when evicted or cleared.
+ */
+class KemCache {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 64;
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        std::size_t size;
+        std::size_t capacity;
+    };
+
+    static KemCache& getInstance();
+
+    // Writes CbcHmacImpl::KEM_SIZE bytes of key expansion for key to kem, deriving it on a miss.
+    void get(const char* key, std::size_t keylen, unsigned char* kem);
+    // CbcHmacImpl for key, with the key expansion taken from the cache.
+    CbcHmacImpl cbcHmac(const char* key, std::size_t keylen);
+    // 0 disables the cache.
+    void setCapacity(std::size_t capacity);
+    void clear();
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Entry {
+        std::string fingerprint;
+        unsigned char kem[CbcHmacImpl::KEM_SIZE];
+    };
+    using EntryList = std::list<Entry>;
+
+    KemCache();
+
+    std::string fingerprint(const char* key, std::size_t keylen) const;
+    std::size_t shrink(std::size_t capacity);
+
+    mutable std::mutex _mutex;
+    // Most recently used first.
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _index;
+    unsigned char _salt[32];
+    std::size_t _capacity = DEFAULT_CAPACITY;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_KEMCACHE_HPP_
@@ -0,0 +1,35 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PBKDF2IMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PBKDF2IMPL_HPP_
+
+#include <cstddef>
+#include <privmx/drv/HashImpl.hpp>
+#include <string>
+
+/**
+ * Native PBKDF2 (RFC 8018) with HMAC-SHA1/256/512, run on the calling thread.
+ * The keyed HMAC state is prepared once and restored for every iteration without allocating.
+ */
+class Pbkdf2Impl {
+public:
+    // Digest names accepted by the JS driver: "sha1", "sha256", "sha512", in either case.
+    static HashImpl::Algorithm fromConfig(const char* hash);
+    // True if data is well-formed UTF-8. The JS driver gets password and salt as JS strings, which turns
+    // anything else into U+FFFD; derive uses the bytes as given, so only well-formed input matches it.
+    static bool isUtf8(const char* data, std::size_t len);
+    // Throws if rounds is 0.
+    static std::string derive(HashImpl::Algorithm algorithm, const char* pass, std::size_t passlen, const char* salt,
+                              std::size_t saltlen, std::size_t rounds, std::size_t length);
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PBKDF2IMPL_HPP_
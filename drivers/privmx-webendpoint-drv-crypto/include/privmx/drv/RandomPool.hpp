@@ -0,0 +1,45 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_RANDOMPOOL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_RANDOMPOOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Per-thread buffer of CSPRNG output for small requests (IVs, nonces, keys).
+ * Pools are refilled in bulk with getentropy(), which emscripten serves from crypto.getRandomValues
+ * of the calling worker's own JS context, so no request is proxied to another thread. Served bytes
+ * are wiped from the pool.
+ */
+class RandomPool {
+public:
+    static constexpr std::size_t POOL_SIZE = 4096;
+    // Larger requests bypass the pool and are filled directly.
+    static constexpr std::size_t MAX_POOLED = 256;
+
+    struct Stats {
+        uint64_t pooledCalls;
+        uint64_t directCalls;
+        uint64_t refills;
+        uint64_t fallbacks;
+    };
+
+    // Returns false if no entropy source is available; buf is left unspecified then.
+    static bool fill(char* buf, std::size_t len);
+    // Counts a request the caller had to serve elsewhere after fill() failed.
+    static void recordFallback();
+    static Stats getStats();
+    static void resetStats();
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_RANDOMPOOL_HPP_
@@ -32,9 +32,60 @@ int privmxDrvCrypto_aeadDecrypt(
     const char* key, const char* iv, const char* aad, unsigned int aadlen, const char* data, unsigned int datalen, const char* tag, unsigned int taglen,
         const char* config, char** out, unsigned int* outlen
 );
+// aes256CbcHmac256 in one call: KEM from key via the SHA-256 kdf, AES-256-CBC over 16 zero bytes || data, HMAC-SHA256 tag of
+// taglen (1-32) bytes appended. Decrypt verifies the tag in constant time before decrypting; the IV is the first cipher block.
+int privmxDrvCrypto_aes256CbcHmac256Encrypt(const char* key, unsigned int keylen, const char* iv, const char* data, unsigned int datalen, unsigned int taglen, char** out, unsigned int* outlen);
+int privmxDrvCrypto_aes256CbcHmac256Decrypt(const char* key, unsigned int keylen, const char* data, unsigned int datalen, unsigned int taglen, char** out, unsigned int* outlen);
+// pass and salt are taken as UTF-8 like the JS driver does: invalid sequences become U+FFFD, so such input always derives in JS.
 int privmxDrvCrypto_pbkdf2(const char* pass, unsigned int passlen, const char* salt, unsigned int saltlen, int rounds, unsigned int length, const char* hash, char** out, unsigned int* outlen);
 int privmxDrvCrypto_freeMem(void* ptr);
 
+// Incremental contexts, run natively on the calling thread. *Init stores a handle in *ctx; *Final releases it whether it succeeds
+// or not, *Free releases an abandoned one. Update/Final outputs are released with privmxDrvCrypto_freeMem. All of them return
+// non-zero on a null handle or output pointer.
+int privmxDrvCrypto_mdInit(const char* config, void** ctx);
+int privmxDrvCrypto_mdUpdate(void* ctx, const char* data, unsigned int datalen);
+int privmxDrvCrypto_mdFinal(void* ctx, char** out, unsigned int* outlen);
+int privmxDrvCrypto_mdFree(void* ctx);
+// config: "AES-256-CBC" or "AES-256-CBC-NOPAD"; encrypt != 0 encrypts. Updates output whole blocks, decryption holds back the last one.
+int privmxDrvCrypto_aesInit(const char* key, const char* iv, const char* config, int encrypt, void** ctx);
+int privmxDrvCrypto_aesUpdate(void* ctx, const char* data, unsigned int datalen, char** out, unsigned int* outlen);
+int privmxDrvCrypto_aesFinal(void* ctx, char** out, unsigned int* outlen);
+int privmxDrvCrypto_aesFree(void* ctx);
+// config: "AES-256-GCM". Decrypted update output is unauthenticated until privmxDrvCrypto_aeadDecryptFinal returned 0; discard it otherwise.
+int privmxDrvCrypto_aeadInit(const char* key, const char* iv, const char* aad, unsigned int aadlen, const char* config, int encrypt, void** ctx);
+int privmxDrvCrypto_aeadUpdate(void* ctx, const char* data, unsigned int datalen, char** out, unsigned int* outlen);
+int privmxDrvCrypto_aeadEncryptFinal(void* ctx, char** out, unsigned int* outlen, char** tag, unsigned int* taglen);
+int privmxDrvCrypto_aeadDecryptFinal(void* ctx, const char* tag, unsigned int taglen, char** out, unsigned int* outlen);
+int privmxDrvCrypto_aeadFree(void* ctx);
+
+// Batch variants: item i reads data[i]/datalens[i] (and keys[i], ivs[i]) and gets outs[i]/outlens[i], each released with
+// privmxDrvCrypto_freeMem. All items that go to JS share one round trip. Returns 1 if any item failed; failed items have outs[i] == NULL.
+int privmxDrvCrypto_mdBatch(const char* const* data, const unsigned int* datalens, unsigned int count, const char* config, char** outs, unsigned int* outlens);
+int privmxDrvCrypto_hmacBatch(const char* const* keys, const unsigned int* keylens, const char* const* data, const unsigned int* datalens, unsigned int count, const char* config, char** outs, unsigned int* outlens);
+int privmxDrvCrypto_aesDecryptBatch(const char* const* keys, const char* const* ivs, const char* const* data, const unsigned int* datalens, unsigned int count, const char* config, char** outs, unsigned int* outlens);
+
+// Selects where an operation ("md", "hmac", "aes", "aead", "cbchmac", "pbkdf2") runs: mode 0 = auto (native below threshold bytes, JS above), 1 = native, 2 = JS.
+// For "pbkdf2" the threshold and the byte counters are in iterations; it defaults to native.
+int privmxDrvCrypto_setDispatch(const char* op, int mode, unsigned int threshold);
+// Per-path counters of an operation: stats[4] = {native calls, native bytes, JS calls, JS bytes}.
+int privmxDrvCrypto_getDispatchStats(const char* op, double* stats);
+int privmxDrvCrypto_resetDispatchStats(void);
+// Imported WebCrypto key cache of the JS crypto thread (LRU, default 256 keys); capacity 0 disables it.
+int privmxDrvCrypto_setKeyCacheCapacity(unsigned int capacity);
+// Also clears the JS key expansion cache.
+int privmxDrvCrypto_clearKeyCache(void);
+// stats[5] = {hits, misses, evictions, size, capacity}; a non-zero reset zeroes the counters afterwards.
+int privmxDrvCrypto_getKeyCacheStats(double* stats, int reset);
+// Native aes256CbcHmac256 key expansion cache (LRU, default 64 keys, entries zeroed on eviction); capacity 0 disables it.
+// Unlike the key cache these run in place and may be called from any thread. stats[5] as for the key cache.
+int privmxDrvCrypto_setKemCacheCapacity(unsigned int capacity);
+int privmxDrvCrypto_clearKemCache(void);
+int privmxDrvCrypto_getKemCacheStats(double* stats, int reset);
+// randomBytes counters: stats[4] = {calls served from the per-thread pool, calls over 256 bytes filled directly, pool refills,
+// calls forwarded to the crypto thread because no in-thread entropy source was available}.
+int privmxDrvCrypto_getRandomStats(double* stats, int reset);
+
 #ifdef __cplusplus
 }
 #endif
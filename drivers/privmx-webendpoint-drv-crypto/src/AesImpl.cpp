@@ -0,0 +1,630 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <privmx/drv/AesImpl.hpp>
+#include <stdexcept>
+
+// Bitsliced AES after BearSSL's aes_ct64 (Thomas Pornin, MIT licence). The state of four blocks is
+// held in eight 64-bit words, q[i] carrying bit i of all 64 state bytes, so the S-box is a boolean
+// circuit (Boyar-Peralta) and there are no key or data dependent memory accesses.
+
+namespace {
+
+inline uint32_t load32le(const unsigned char* src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+inline void store32le(unsigned char* dst, uint32_t x) {
+    dst[0] = (unsigned char)x;
+    dst[1] = (unsigned char)(x >> 8);
+    dst[2] = (unsigned char)(x >> 16);
+    dst[3] = (unsigned char)(x >> 24);
+}
+
+inline void swapn(uint64_t cl, uint64_t ch, int s, uint64_t& x, uint64_t& y) {
+    uint64_t a = x, b = y;
+    x = (a & cl) | ((b & cl) << s);
+    y = ((a & ch) >> s) | (b & ch);
+}
+
+void ortho(uint64_t* q) {
+    const uint64_t cl2 = 0x5555555555555555, ch2 = 0xAAAAAAAAAAAAAAAA;
+    const uint64_t cl4 = 0x3333333333333333, ch4 = 0xCCCCCCCCCCCCCCCC;
+    const uint64_t cl8 = 0x0F0F0F0F0F0F0F0F, ch8 = 0xF0F0F0F0F0F0F0F0;
+    swapn(cl2, ch2, 1, q[0], q[1]);
+    swapn(cl2, ch2, 1, q[2], q[3]);
+    swapn(cl2, ch2, 1, q[4], q[5]);
+    swapn(cl2, ch2, 1, q[6], q[7]);
+    swapn(cl4, ch4, 2, q[0], q[2]);
+    swapn(cl4, ch4, 2, q[1], q[3]);
+    swapn(cl4, ch4, 2, q[4], q[6]);
+    swapn(cl4, ch4, 2, q[5], q[7]);
+    swapn(cl8, ch8, 4, q[0], q[4]);
+    swapn(cl8, ch8, 4, q[1], q[5]);
+    swapn(cl8, ch8, 4, q[2], q[6]);
+    swapn(cl8, ch8, 4, q[3], q[7]);
+}
+
+void interleaveIn(uint64_t& q0, uint64_t& q1, const uint32_t* w) {
+    uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= (x0 << 16);
+    x1 |= (x1 << 16);
+    x2 |= (x2 << 16);
+    x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    x0 |= (x0 << 8);
+    x1 |= (x1 << 8);
+    x2 |= (x2 << 8);
+    x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FF;
+    x1 &= 0x00FF00FF00FF00FF;
+    x2 &= 0x00FF00FF00FF00FF;
+    x3 &= 0x00FF00FF00FF00FF;
+    q0 = x0 | (x2 << 8);
+    q1 = x1 | (x3 << 8);
+}
+
+void interleaveOut(uint32_t* w, uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FF;
+    uint64_t x1 = q1 & 0x00FF00FF00FF00FF;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FF;
+    uint64_t x3 = (q1 >> 8) & 0x00FF00FF00FF00FF;
+    x0 |= (x0 >> 8);
+    x1 |= (x1 >> 8);
+    x2 |= (x2 >> 8);
+    x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    w[0] = (uint32_t)x0 | (uint32_t)(x0 >> 16);
+    w[1] = (uint32_t)x1 | (uint32_t)(x1 >> 16);
+    w[2] = (uint32_t)x2 | (uint32_t)(x2 >> 16);
+    w[3] = (uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+void sbox(uint64_t* q) {
+    uint64_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // Top linear transformation.
+    uint64_t y14 = x3 ^ x5;
+    uint64_t y13 = x0 ^ x6;
+    uint64_t y9 = x0 ^ x3;
+    uint64_t y8 = x0 ^ x5;
+    uint64_t t0 = x1 ^ x2;
+    uint64_t y1 = t0 ^ x7;
+    uint64_t y4 = y1 ^ x3;
+    uint64_t y12 = y13 ^ y14;
+    uint64_t y2 = y1 ^ x0;
+    uint64_t y5 = y1 ^ x6;
+    uint64_t y3 = y5 ^ y8;
+    uint64_t t1 = x4 ^ y12;
+    uint64_t y15 = t1 ^ x5;
+    uint64_t y20 = t1 ^ x1;
+    uint64_t y6 = y15 ^ x7;
+    uint64_t y10 = y15 ^ t0;
+    uint64_t y11 = y20 ^ y9;
+    uint64_t y7 = x7 ^ y11;
+    uint64_t y17 = y10 ^ y11;
+    uint64_t y19 = y10 ^ y8;
+    uint64_t y16 = t0 ^ y11;
+    uint64_t y21 = y13 ^ y16;
+    uint64_t y18 = x0 ^ y16;
+
+    // Non-linear section.
+    uint64_t t2 = y12 & y15;
+    uint64_t t3 = y3 & y6;
+    uint64_t t4 = t3 ^ t2;
+    uint64_t t5 = y4 & x7;
+    uint64_t t6 = t5 ^ t2;
+    uint64_t t7 = y13 & y16;
+    uint64_t t8 = y5 & y1;
+    uint64_t t9 = t8 ^ t7;
+    uint64_t t10 = y2 & y7;
+    uint64_t t11 = t10 ^ t7;
+    uint64_t t12 = y9 & y11;
+    uint64_t t13 = y14 & y17;
+    uint64_t t14 = t13 ^ t12;
+    uint64_t t15 = y8 & y10;
+    uint64_t t16 = t15 ^ t12;
+    uint64_t t17 = t4 ^ t14;
+    uint64_t t18 = t6 ^ t16;
+    uint64_t t19 = t9 ^ t14;
+    uint64_t t20 = t11 ^ t16;
+    uint64_t t21 = t17 ^ y20;
+    uint64_t t22 = t18 ^ y19;
+    uint64_t t23 = t19 ^ y21;
+    uint64_t t24 = t20 ^ y18;
+
+    uint64_t t25 = t21 ^ t22;
+    uint64_t t26 = t21 & t23;
+    uint64_t t27 = t24 ^ t26;
+    uint64_t t28 = t25 & t27;
+    uint64_t t29 = t28 ^ t22;
+    uint64_t t30 = t23 ^ t24;
+    uint64_t t31 = t22 ^ t26;
+    uint64_t t32 = t31 & t30;
+    uint64_t t33 = t32 ^ t24;
+    uint64_t t34 = t23 ^ t33;
+    uint64_t t35 = t27 ^ t33;
+    uint64_t t36 = t24 & t35;
+    uint64_t t37 = t36 ^ t34;
+    uint64_t t38 = t27 ^ t36;
+    uint64_t t39 = t29 & t38;
+    uint64_t t40 = t25 ^ t39;
+
+    uint64_t t41 = t40 ^ t37;
+    uint64_t t42 = t29 ^ t33;
+    uint64_t t43 = t29 ^ t40;
+    uint64_t t44 = t33 ^ t37;
+    uint64_t t45 = t42 ^ t41;
+    uint64_t z0 = t44 & y15;
+    uint64_t z1 = t37 & y6;
+    uint64_t z2 = t33 & x7;
+    uint64_t z3 = t43 & y16;
+    uint64_t z4 = t40 & y1;
+    uint64_t z5 = t29 & y7;
+    uint64_t z6 = t42 & y11;
+    uint64_t z7 = t45 & y17;
+    uint64_t z8 = t41 & y10;
+    uint64_t z9 = t44 & y12;
+    uint64_t z10 = t37 & y3;
+    uint64_t z11 = t33 & y4;
+    uint64_t z12 = t43 & y13;
+    uint64_t z13 = t40 & y5;
+    uint64_t z14 = t29 & y2;
+    uint64_t z15 = t42 & y9;
+    uint64_t z16 = t45 & y14;
+    uint64_t z17 = t41 & y8;
+
+    // Bottom linear transformation.
+    uint64_t t46 = z15 ^ z16;
+    uint64_t t47 = z10 ^ z11;
+    uint64_t t48 = z5 ^ z13;
+    uint64_t t49 = z9 ^ z10;
+    uint64_t t50 = z2 ^ z12;
+    uint64_t t51 = z2 ^ z5;
+    uint64_t t52 = z7 ^ z8;
+    uint64_t t53 = z0 ^ z3;
+    uint64_t t54 = z6 ^ z7;
+    uint64_t t55 = z16 ^ z17;
+    uint64_t t56 = z12 ^ t48;
+    uint64_t t57 = t50 ^ t53;
+    uint64_t t58 = z4 ^ t46;
+    uint64_t t59 = z3 ^ t54;
+    uint64_t t60 = t46 ^ t57;
+    uint64_t t61 = z14 ^ t57;
+    uint64_t t62 = t52 ^ t58;
+    uint64_t t63 = t49 ^ t58;
+    uint64_t t64 = z4 ^ t59;
+    uint64_t t65 = t61 ^ t62;
+    uint64_t t66 = z1 ^ t63;
+    uint64_t s0 = t59 ^ t63;
+    uint64_t s6 = t56 ^ ~t62;
+    uint64_t s7 = t48 ^ ~t60;
+    uint64_t t67 = t64 ^ t65;
+    uint64_t s3 = t53 ^ t66;
+    uint64_t s4 = t51 ^ t66;
+    uint64_t s5 = t47 ^ t65;
+    uint64_t s1 = t64 ^ ~s3;
+    uint64_t s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+// Inverse of the affine part of the S-box; InvSubBytes = affine^-1 o SubBytes o affine^-1.
+void invAffine(uint64_t* q) {
+    uint64_t q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+void invSbox(uint64_t* q) {
+    invAffine(q);
+    sbox(q);
+    invAffine(q);
+}
+
+void addRoundKey(uint64_t* q, const uint64_t* sk) {
+    for (int i = 0; i < 8; ++i) q[i] ^= sk[i];
+}
+
+void shiftRows(uint64_t* q) {
+    for (int i = 0; i < 8; ++i) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFF) | ((x & 0x00000000FFF00000) >> 4) | ((x & 0x00000000000F0000) << 12) |
+               ((x & 0x0000FF0000000000) >> 8) | ((x & 0x000000FF00000000) << 8) |
+               ((x & 0xF000000000000000) >> 12) | ((x & 0x0FFF000000000000) << 4);
+    }
+}
+
+void invShiftRows(uint64_t* q) {
+    for (int i = 0; i < 8; ++i) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFF) | ((x & 0x000000000FFF0000) << 4) | ((x & 0x00000000F0000000) >> 12) |
+               ((x & 0x000000FF00000000) << 8) | ((x & 0x0000FF0000000000) >> 8) |
+               ((x & 0x000F000000000000) << 12) | ((x & 0xFFF0000000000000) >> 4);
+    }
+}
+
+inline uint64_t rotr32(uint64_t x) {
+    return (x << 32) | (x >> 32);
+}
+
+void mixColumns(uint64_t* q) {
+    uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    uint64_t r0 = (q0 >> 16) | (q0 << 48);
+    uint64_t r1 = (q1 >> 16) | (q1 << 48);
+    uint64_t r2 = (q2 >> 16) | (q2 << 48);
+    uint64_t r3 = (q3 >> 16) | (q3 << 48);
+    uint64_t r4 = (q4 >> 16) | (q4 << 48);
+    uint64_t r5 = (q5 >> 16) | (q5 << 48);
+    uint64_t r6 = (q6 >> 16) | (q6 << 48);
+    uint64_t r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+}
+
+void invMixColumns(uint64_t* q) {
+    uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    uint64_t r0 = (q0 >> 16) | (q0 << 48);
+    uint64_t r1 = (q1 >> 16) | (q1 << 48);
+    uint64_t r2 = (q2 >> 16) | (q2 << 48);
+    uint64_t r3 = (q3 >> 16) | (q3 << 48);
+    uint64_t r4 = (q4 >> 16) | (q4 << 48);
+    uint64_t r5 = (q5 >> 16) | (q5 << 48);
+    uint64_t r6 = (q6 >> 16) | (q6 << 48);
+    uint64_t r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ rotr32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+    q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+    q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ rotr32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+    q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^ rotr32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+    q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+    q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+    q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^ rotr32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+    q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^ rotr32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+uint32_t subWord(uint32_t x) {
+    uint64_t q[8] = {x, 0, 0, 0, 0, 0, 0, 0};
+    ortho(q);
+    sbox(q);
+    ortho(q);
+    return (uint32_t)q[0];
+}
+
+// Loads up to four blocks into the bitsliced state; missing blocks are zero.
+void loadBlocks(uint64_t* q, const unsigned char* in, std::size_t blocks) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        uint32_t w[4] = {0, 0, 0, 0};
+        if (i < blocks) {
+            for (int j = 0; j < 4; ++j) w[j] = load32le(in + 16 * i + 4 * j);
+        }
+        interleaveIn(q[i], q[i + 4], w);
+    }
+    ortho(q);
+}
+
+void storeBlocks(uint64_t* q, unsigned char* out, std::size_t blocks) {
+    ortho(q);
+    for (std::size_t i = 0; i < blocks; ++i) {
+        uint32_t w[4];
+        interleaveOut(w, q[i], q[i + 4]);
+        for (int j = 0; j < 4; ++j) store32le(out + 16 * i + 4 * j, w[j]);
+    }
+}
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+void requireBlocks(std::size_t datalen) {
+    if (datalen % AesImpl::BLOCK_SIZE != 0) {
+        throw std::runtime_error("Data length is not a multiple of the AES block size");
+    }
+}
+
+void requireIv(const char* iv) {
+    if (iv == nullptr) {
+        throw std::runtime_error("Missing AES-CBC IV");
+    }
+}
+
+// Strips PKCS#7 padding. The padding bytes are checked without data dependent branches, only the
+// final valid/invalid outcome is observable.
+std::size_t unpad(const unsigned char* data, std::size_t datalen) {
+    if (datalen == 0) {
+        throw std::runtime_error("Invalid padding");
+    }
+    const unsigned char* last = data + datalen - AesImpl::BLOCK_SIZE;
+    uint32_t pad = last[AesImpl::BLOCK_SIZE - 1];
+    // bad == 0 iff 1 <= pad <= 16
+    uint32_t bad = ((pad - 1) >> 8) | ((16 - pad) >> 8);
+    for (uint32_t i = 0; i < AesImpl::BLOCK_SIZE; ++i) {
+        // inPad is all ones for the last pad bytes
+        uint32_t inPad = 0u - (((uint32_t)(AesImpl::BLOCK_SIZE - 1) - i - pad) >> 31);
+        bad |= inPad & (last[i] ^ pad);
+    }
+    if (bad != 0) {
+        throw std::runtime_error("Invalid padding");
+    }
+    return datalen - pad;
+}
+
+}  // namespace
+
+AesImpl::Mode AesImpl::fromConfig(const char* config) {
+    if (strcmp(config, "AES-256-CBC") == 0) return Mode::CBC_PKCS7;
+    if (strcmp(config, "AES-256-CBC-NOPAD") == 0) return Mode::CBC_NOPAD;
+    if (strcmp(config, "AES-256-ECB-NOPAD") == 0) return Mode::ECB_NOPAD;
+    throw std::runtime_error("Wrong aes256 config");
+}
+
+AesImpl::AesImpl(const char* key) {
+    const unsigned nk = KEY_SIZE / 4;
+    const unsigned nkf = (ROUNDS + 1) * 4;
+    static const unsigned char rcon[] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+    uint32_t w[(ROUNDS + 1) * 4];
+    for (unsigned i = 0; i < nk; ++i) {
+        w[i] = load32le(reinterpret_cast<const unsigned char*>(key) + 4 * i);
+    }
+    uint32_t tmp = w[nk - 1];
+    for (unsigned i = nk, j = 0, k = 0; i < nkf; ++i) {
+        if (j == 0) {
+            tmp = (tmp << 24) | (tmp >> 8);
+            tmp = subWord(tmp) ^ rcon[k];
+        } else if (j == 4) {
+            tmp = subWord(tmp);
+        }
+        tmp ^= w[i - nk];
+        w[i] = tmp;
+        if (++j == nk) {
+            j = 0;
+            ++k;
+        }
+    }
+    // Each round key is bitsliced once and replicated to all four block lanes.
+    for (unsigned i = 0; i < nkf; i += 4) {
+        uint64_t q[8];
+        interleaveIn(q[0], q[4], w + i);
+        q[1] = q[2] = q[3] = q[0];
+        q[5] = q[6] = q[7] = q[4];
+        ortho(q);
+        uint64_t comp[2];
+        comp[0] = (q[0] & 0x1111111111111111) | (q[1] & 0x2222222222222222) | (q[2] & 0x4444444444444444) |
+                  (q[3] & 0x8888888888888888);
+        comp[1] = (q[4] & 0x1111111111111111) | (q[5] & 0x2222222222222222) | (q[6] & 0x4444444444444444) |
+                  (q[7] & 0x8888888888888888);
+        uint64_t* sk = _skey + 2 * i;
+        for (int u = 0; u < 2; ++u) {
+            uint64_t x0 = comp[u] & 0x1111111111111111;
+            uint64_t x1 = (comp[u] & 0x2222222222222222) >> 1;
+            uint64_t x2 = (comp[u] & 0x4444444444444444) >> 2;
+            uint64_t x3 = (comp[u] & 0x8888888888888888) >> 3;
+            sk[4 * u + 0] = (x0 << 4) - x0;
+            sk[4 * u + 1] = (x1 << 4) - x1;
+            sk[4 * u + 2] = (x2 << 4) - x2;
+            sk[4 * u + 3] = (x3 << 4) - x3;
+        }
+        secureZero(q, sizeof(q));
+        secureZero(comp, sizeof(comp));
+    }
+    secureZero(w, sizeof(w));
+}
+
+AesImpl::~AesImpl() {
+    secureZero(_skey, sizeof(_skey));
+}
+
+void AesImpl::encryptBlocks(const unsigned char* in, unsigned char* out, std::size_t blocks) const {
+    uint64_t q[8];
+    for (std::size_t done = 0; done < blocks; done += 4) {
+        std::size_t n = blocks - done < 4 ? blocks - done : 4;
+        loadBlocks(q, in + 16 * done, n);
+        addRoundKey(q, _skey);
+        for (unsigned u = 1; u < ROUNDS; ++u) {
+            sbox(q);
+            shiftRows(q);
+            mixColumns(q);
+            addRoundKey(q, _skey + 8 * u);
+        }
+        sbox(q);
+        shiftRows(q);
+        addRoundKey(q, _skey + 8 * ROUNDS);
+        storeBlocks(q, out + 16 * done, n);
+    }
+    secureZero(q, sizeof(q));
+}
+
+void AesImpl::decryptBlocks(const unsigned char* in, unsigned char* out, std::size_t blocks) const {
+    uint64_t q[8];
+    for (std::size_t done = 0; done < blocks; done += 4) {
+        std::size_t n = blocks - done < 4 ? blocks - done : 4;
+        loadBlocks(q, in + 16 * done, n);
+        addRoundKey(q, _skey + 8 * ROUNDS);
+        for (unsigned u = ROUNDS - 1; u > 0; --u) {
+            invShiftRows(q);
+            invSbox(q);
+            addRoundKey(q, _skey + 8 * u);
+            invMixColumns(q);
+        }
+        invShiftRows(q);
+        invSbox(q);
+        addRoundKey(q, _skey);
+        storeBlocks(q, out + 16 * done, n);
+    }
+    secureZero(q, sizeof(q));
+}
+
+void AesImpl::cbcEncrypt(unsigned char* iv, const unsigned char* in, unsigned char* out, std::size_t blocks) const {
+    for (std::size_t i = 0; i < blocks; ++i) {
+        for (std::size_t j = 0; j < BLOCK_SIZE; ++j) iv[j] ^= in[BLOCK_SIZE * i + j];
+        encryptBlocks(iv, iv, 1);
+        memcpy(out + BLOCK_SIZE * i, iv, BLOCK_SIZE);
+    }
+}
+
+void AesImpl::cbcDecrypt(unsigned char* iv, const unsigned char* in, unsigned char* out, std::size_t blocks) const {
+    // Decryption is parallel: four ciphertext blocks per pass, chained afterwards.
+    unsigned char plain[4 * BLOCK_SIZE];
+    for (std::size_t done = 0; done < blocks; done += 4) {
+        std::size_t n = blocks - done < 4 ? blocks - done : 4;
+        const unsigned char* cipher = in + BLOCK_SIZE * done;
+        decryptBlocks(cipher, plain, n);
+        for (std::size_t j = 0; j < BLOCK_SIZE; ++j) plain[j] ^= iv[j];
+        for (std::size_t j = BLOCK_SIZE; j < n * BLOCK_SIZE; ++j) plain[j] ^= cipher[j - BLOCK_SIZE];
+        memcpy(iv, cipher + (n - 1) * BLOCK_SIZE, BLOCK_SIZE);
+        memcpy(out + BLOCK_SIZE * done, plain, n * BLOCK_SIZE);
+    }
+    secureZero(plain, sizeof(plain));
+}
+
+std::string AesImpl::encrypt(Mode mode, const char* iv, const char* data, std::size_t datalen) const {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    if (mode == Mode::ECB_NOPAD) {
+        requireBlocks(datalen);
+        std::string result(datalen, '\0');
+        encryptBlocks(in, reinterpret_cast<unsigned char*>(&result[0]), datalen / BLOCK_SIZE);
+        return result;
+    }
+    requireIv(iv);
+    unsigned char chain[BLOCK_SIZE];
+    memcpy(chain, iv, BLOCK_SIZE);
+    std::size_t full = datalen / BLOCK_SIZE;
+    if (mode == Mode::CBC_NOPAD) {
+        requireBlocks(datalen);
+        std::string result(datalen, '\0');
+        cbcEncrypt(chain, in, reinterpret_cast<unsigned char*>(&result[0]), full);
+        return result;
+    }
+    std::string result((full + 1) * BLOCK_SIZE, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    cbcEncrypt(chain, in, out, full);
+    unsigned char last[BLOCK_SIZE];
+    std::size_t rest = datalen - full * BLOCK_SIZE;
+    memcpy(last, in + full * BLOCK_SIZE, rest);
+    memset(last + rest, (int)(BLOCK_SIZE - rest), BLOCK_SIZE - rest);
+    cbcEncrypt(chain, last, out + full * BLOCK_SIZE, 1);
+    secureZero(last, sizeof(last));
+    return result;
+}
+
+std::string AesImpl::decrypt(Mode mode, const char* iv, const char* data, std::size_t datalen) const {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    requireBlocks(datalen);
+    std::string result(datalen, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    if (mode == Mode::ECB_NOPAD) {
+        decryptBlocks(in, out, datalen / BLOCK_SIZE);
+        return result;
+    }
+    requireIv(iv);
+    unsigned char chain[BLOCK_SIZE];
+    memcpy(chain, iv, BLOCK_SIZE);
+    cbcDecrypt(chain, in, out, datalen / BLOCK_SIZE);
+    // The JS driver decrypts AES-256-CBC-NOPAD with padding enabled as well, so both configs strip
+    // and validate PKCS#7 padding here to stay byte-identical with it.
+    try {
+        result.resize(unpad(out, datalen));
+    } catch (...) {
+        secureZero(out, datalen);
+        throw;
+    }
+    return result;
+}
+
+AesImpl::CbcStream::CbcStream(const char* key, Mode mode, bool encrypt, const char* iv)
+    : _aes(key), _mode(mode), _encrypt(encrypt) {
+    if (mode == Mode::ECB_NOPAD) {
+        throw std::runtime_error("Wrong aes256 stream config");
+    }
+    requireIv(iv);
+    memcpy(_chain, iv, BLOCK_SIZE);
+}
+
+AesImpl::CbcStream::~CbcStream() {
+    secureZero(_chain, sizeof(_chain));
+    secureZero(_buffer, sizeof(_buffer));
+}
+
+void AesImpl::CbcStream::process(const unsigned char* in, unsigned char* out, std::size_t blocks) {
+    if (_encrypt) {
+        _aes.cbcEncrypt(_chain, in, out, blocks);
+    } else {
+        _aes.cbcDecrypt(_chain, in, out, blocks);
+    }
+}
+
+std::string AesImpl::CbcStream::update(const char* data, std::size_t datalen) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    std::size_t total = _buffered + datalen;
+    std::size_t blocks = total / BLOCK_SIZE;
+    if (!_encrypt && blocks > 0 && total % BLOCK_SIZE == 0) {
+        // The last block may carry padding, finish() decides
+        --blocks;
+    }
+    std::string result(blocks * BLOCK_SIZE, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    if (blocks > 0 && _buffered > 0) {
+        std::size_t take = BLOCK_SIZE - _buffered;
+        memcpy(_buffer + _buffered, in, take);
+        process(_buffer, out, 1);
+        in += take;
+        datalen -= take;
+        out += BLOCK_SIZE;
+        --blocks;
+        _buffered = 0;
+    }
+    process(in, out, blocks);
+    in += blocks * BLOCK_SIZE;
+    datalen -= blocks * BLOCK_SIZE;
+    if (datalen > 0) {
+        memcpy(_buffer + _buffered, in, datalen);
+        _buffered += datalen;
+    }
+    return result;
+}
+
+std::string AesImpl::CbcStream::finish() {
+    const char* chain = reinterpret_cast<const char*>(_chain);
+    const char* rest = reinterpret_cast<const char*>(_buffer);
+    std::string result =
+        _encrypt ? _aes.encrypt(_mode, chain, rest, _buffered) : _aes.decrypt(_mode, chain, rest, _buffered);
+    _buffered = 0;
+    return result;
+}
@@ -0,0 +1,104 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <privmx/drv/CbcHmacImpl.hpp>
+#include <stdexcept>
+
+namespace {
+
+const std::size_t MAC_KEY_SIZE = CbcHmacImpl::KEM_SIZE - AesImpl::KEY_SIZE;
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+}  // namespace
+
+bool CbcHmacImpl::isValidTagSize(std::size_t taglen) {
+    return taglen > 0 && taglen <= MAX_TAG_SIZE;
+}
+
+// kdf(SHA-256, 64, key, "key expansion"): k_i = HMAC(key, k_{i-1} || uint32be(i) || label || 0x00 || uint32be(64))
+void CbcHmacImpl::deriveKem(const char* key, std::size_t keylen, unsigned char* kem) {
+    static const char seed[] = "key expansion\0\0\0\0\x40";
+    HmacImpl keyed(HashImpl::Algorithm::SHA256, key, keylen);
+    HmacImpl first(keyed);
+    const char counter1[4] = {0, 0, 0, 1};
+    first.update(counter1, sizeof(counter1));
+    first.update(seed, sizeof(seed) - 1);
+    first.digest(kem);
+    HmacImpl second(keyed);
+    second.update(reinterpret_cast<const char*>(kem), AesImpl::KEY_SIZE);
+    const char counter2[4] = {0, 0, 0, 2};
+    second.update(counter2, sizeof(counter2));
+    second.update(seed, sizeof(seed) - 1);
+    second.digest(kem + AesImpl::KEY_SIZE);
+}
+
+CbcHmacImpl::Kem::Kem(const char* key, std::size_t keylen) {
+    deriveKem(key, keylen, bytes);
+}
+
+CbcHmacImpl::Kem::~Kem() {
+    secureZero(bytes, sizeof(bytes));
+}
+
+CbcHmacImpl::CbcHmacImpl(const char* key, std::size_t keylen) : CbcHmacImpl(Kem(key, keylen).bytes) {}
+
+CbcHmacImpl::CbcHmacImpl(const unsigned char* kem)
+    : _aes(reinterpret_cast<const char*>(kem)),
+      _mac(HashImpl::Algorithm::SHA256, reinterpret_cast<const char*>(kem) + AesImpl::KEY_SIZE, MAC_KEY_SIZE) {}
+
+std::string CbcHmacImpl::encrypt(const char* iv, const char* data, std::size_t datalen, std::size_t taglen) const {
+    if (!isValidTagSize(taglen)) {
+        throw std::runtime_error("Invalid aes256CbcHmac256 tag length");
+    }
+    if (iv == nullptr) {
+        throw std::runtime_error("Missing AES-CBC IV");
+    }
+    // The zero prefix block encrypts to E(iv); continuing the chain from it is the same as encrypting
+    // zeros || data in one go, without copying data.
+    std::string result(AesImpl::BLOCK_SIZE, '\0');
+    unsigned char chain[AesImpl::BLOCK_SIZE];
+    memcpy(chain, iv, AesImpl::BLOCK_SIZE);
+    unsigned char* first = reinterpret_cast<unsigned char*>(&result[0]);
+    _aes.cbcEncrypt(chain, first, first, 1);
+    result += _aes.encrypt(AesImpl::Mode::CBC_PKCS7, result.data(), data, datalen);
+    HmacImpl mac(_mac);
+    mac.update(result.data(), result.size());
+    unsigned char tag[MAX_TAG_SIZE];
+    mac.digest(tag);
+    result.append(reinterpret_cast<const char*>(tag), taglen);
+    return result;
+}
+
+std::string CbcHmacImpl::decrypt(const char* data, std::size_t datalen, std::size_t taglen) const {
+    if (!isValidTagSize(taglen)) {
+        throw std::runtime_error("Invalid aes256CbcHmac256 tag length");
+    }
+    if (datalen < 2 * AesImpl::BLOCK_SIZE + taglen) {
+        throw std::runtime_error("Wrong message security tag");
+    }
+    std::size_t cipherlen = datalen - taglen;
+    HmacImpl mac(_mac);
+    mac.update(data, cipherlen);
+    unsigned char expected[MAX_TAG_SIZE];
+    mac.digest(expected);
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < taglen; ++i) diff |= expected[i] ^ (unsigned char)data[cipherlen + i];
+    if (diff != 0) {
+        throw std::runtime_error("Wrong message security tag");
+    }
+    return _aes.decrypt(AesImpl::Mode::CBC_PKCS7, data, data + AesImpl::BLOCK_SIZE, cipherlen - AesImpl::BLOCK_SIZE);
+}
@@ -0,0 +1,101 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <privmx/drv/CryptoDispatch.hpp>
+#include <stdexcept>
+
+namespace {
+
+struct OpDefaults {
+    const char* name;
+    CryptoDispatch::Mode mode;
+    std::size_t threshold;
+};
+
+// Indexed by CryptoDispatch::Op.
+const OpDefaults OP_DEFAULTS[] = {
+    {"md", CryptoDispatch::Mode::AUTO, 16 * 1024},
+    // WebCrypto HMAC also pays an importKey per call
+    {"hmac", CryptoDispatch::Mode::AUTO, 64 * 1024},
+    // bitsliced AES is constant time but slow per byte, CBC encryption uses one of its four lanes
+    {"aes", CryptoDispatch::Mode::AUTO, 4 * 1024},
+    {"aead", CryptoDispatch::Mode::AUTO, 4 * 1024},
+    // the JS path awaits five WebCrypto calls (two kdf HMACs, AES, HMAC) besides the round trip
+    {"cbchmac", CryptoDispatch::Mode::AUTO, 16 * 1024},
+    // sized in iterations; native so that derivations run on their callers' workers in parallel
+    // instead of queueing behind (and blocking) everything else on the crypto thread
+    {"pbkdf2", CryptoDispatch::Mode::NATIVE, 0},
+};
+
+}  // namespace
+
+CryptoDispatch& CryptoDispatch::getInstance() {
+    static CryptoDispatch instance;
+    return instance;
+}
+
+CryptoDispatch::CryptoDispatch() {
+    for (int i = 0; i < (int)Op::COUNT; ++i) {
+        _policies[i].mode = (int)OP_DEFAULTS[i].mode;
+        _policies[i].threshold = OP_DEFAULTS[i].threshold;
+    }
+}
+
+CryptoDispatch::Op CryptoDispatch::opFromName(const char* name) {
+    for (int i = 0; i < (int)Op::COUNT; ++i) {
+        if (strcmp(name, OP_DEFAULTS[i].name) == 0) return (Op)i;
+    }
+    throw std::runtime_error("Unknown crypto operation");
+}
+
+bool CryptoDispatch::useNative(Op op, std::size_t datalen, bool preferNative) const {
+    const Policy& policy = _policies[(int)op];
+    switch ((Mode)policy.mode.load(std::memory_order_relaxed)) {
+        case Mode::NATIVE:
+            return true;
+        case Mode::JS:
+            return false;
+        default:
+            return preferNative || datalen < policy.threshold.load(std::memory_order_relaxed);
+    }
+}
+
+void CryptoDispatch::configure(Op op, Mode mode, std::size_t threshold) {
+    _policies[(int)op].mode = (int)mode;
+    _policies[(int)op].threshold = threshold;
+}
+
+void CryptoDispatch::record(Op op, bool native, std::size_t datalen) {
+    Policy& policy = _policies[(int)op];
+    if (native) {
+        policy.nativeCalls.fetch_add(1, std::memory_order_relaxed);
+        policy.nativeBytes.fetch_add(datalen, std::memory_order_relaxed);
+    } else {
+        policy.jsCalls.fetch_add(1, std::memory_order_relaxed);
+        policy.jsBytes.fetch_add(datalen, std::memory_order_relaxed);
+    }
+}
+
+CryptoDispatch::Stats CryptoDispatch::getStats(Op op) const {
+    const Policy& policy = _policies[(int)op];
+    return Stats{policy.nativeCalls.load(), policy.nativeBytes.load(), policy.jsCalls.load(), policy.jsBytes.load()};
+}
+
+void CryptoDispatch::resetStats() {
+    for (Policy& policy : _policies) {
+        policy.nativeCalls = 0;
+        policy.nativeBytes = 0;
+        policy.jsCalls = 0;
+        policy.jsBytes = 0;
+    }
+}
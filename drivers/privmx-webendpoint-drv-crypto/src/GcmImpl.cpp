@@ -0,0 +1,320 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <privmx/drv/GcmImpl.hpp>
+#include <stdexcept>
+
+// GHASH after BearSSL's ghash_ctmul64 (Thomas Pornin, MIT licence): carry-less products are
+// computed with plain integer multiplications on operands with holes, which keeps carries out of
+// the result bits and has no data dependent timing.
+
+namespace {
+
+inline uint64_t load64be(const unsigned char* src) {
+    uint64_t x = 0;
+    for (int i = 0; i < 8; ++i) x = (x << 8) | src[i];
+    return x;
+}
+
+inline void store64be(unsigned char* dst, uint64_t x) {
+    for (int i = 7; i >= 0; --i) {
+        dst[i] = (unsigned char)x;
+        x >>= 8;
+    }
+}
+
+inline uint64_t bmul64(uint64_t x, uint64_t y) {
+    uint64_t x0 = x & 0x1111111111111111;
+    uint64_t x1 = x & 0x2222222222222222;
+    uint64_t x2 = x & 0x4444444444444444;
+    uint64_t x3 = x & 0x8888888888888888;
+    uint64_t y0 = y & 0x1111111111111111;
+    uint64_t y1 = y & 0x2222222222222222;
+    uint64_t y2 = y & 0x4444444444444444;
+    uint64_t y3 = y & 0x8888888888888888;
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    z0 &= 0x1111111111111111;
+    z1 &= 0x2222222222222222;
+    z2 &= 0x4444444444444444;
+    z3 &= 0x8888888888888888;
+    return z0 | z1 | z2 | z3;
+}
+
+inline uint64_t rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555) << 1) | ((x >> 1) & 0x5555555555555555);
+    x = ((x & 0x3333333333333333) << 2) | ((x >> 2) & 0x3333333333333333);
+    x = ((x & 0x0F0F0F0F0F0F0F0F) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0F);
+    x = ((x & 0x00FF00FF00FF00FF) << 8) | ((x >> 8) & 0x00FF00FF00FF00FF);
+    x = ((x & 0x0000FFFF0000FFFF) << 16) | ((x >> 16) & 0x0000FFFF0000FFFF);
+    return (x << 32) | (x >> 32);
+}
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+}  // namespace
+
+void GcmImpl::checkConfig(const char* config) {
+    if (strcmp(config, "AES-256-GCM") != 0) {
+        throw std::runtime_error("Wrong aead config");
+    }
+}
+
+bool GcmImpl::isValidTagSize(std::size_t taglen) {
+    return taglen == 4 || taglen == 8 || (taglen >= 12 && taglen <= TAG_SIZE);
+}
+
+GcmImpl::GcmImpl(const char* key) : _aes(key) {
+    unsigned char h[AesImpl::BLOCK_SIZE] = {0};
+    _aes.encryptBlocks(h, h, 1);
+    _h1 = load64be(h);
+    _h0 = load64be(h + 8);
+    secureZero(h, sizeof(h));
+}
+
+GcmImpl::~GcmImpl() {
+    secureZero(&_h0, sizeof(_h0));
+    secureZero(&_h1, sizeof(_h1));
+}
+
+void GcmImpl::ghashUpdate(Ghash& state, const unsigned char* data, std::size_t datalen) const {
+    uint64_t h0 = _h0, h1 = _h1;
+    uint64_t h0r = rev64(h0), h1r = rev64(h1);
+    uint64_t h2 = h0 ^ h1, h2r = h0r ^ h1r;
+    uint64_t y0 = state.y0, y1 = state.y1;
+    while (datalen > 0) {
+        unsigned char block[AesImpl::BLOCK_SIZE];
+        const unsigned char* src = data;
+        if (datalen >= AesImpl::BLOCK_SIZE) {
+            data += AesImpl::BLOCK_SIZE;
+            datalen -= AesImpl::BLOCK_SIZE;
+        } else {
+            memcpy(block, data, datalen);
+            memset(block + datalen, 0, AesImpl::BLOCK_SIZE - datalen);
+            src = block;
+            datalen = 0;
+        }
+        y1 ^= load64be(src);
+        y0 ^= load64be(src + 8);
+
+        // Karatsuba on the 64-bit halves; the high halves of the products come from bit-reversed operands.
+        uint64_t y0r = rev64(y0), y1r = rev64(y1);
+        uint64_t y2 = y0 ^ y1, y2r = y0r ^ y1r;
+        uint64_t z0 = bmul64(y0, h0);
+        uint64_t z1 = bmul64(y1, h1);
+        uint64_t z2 = bmul64(y2, h2);
+        uint64_t z0h = bmul64(y0r, h0r);
+        uint64_t z1h = bmul64(y1r, h1r);
+        uint64_t z2h = bmul64(y2r, h2r);
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = rev64(z0h) >> 1;
+        z1h = rev64(z1h) >> 1;
+        z2h = rev64(z2h) >> 1;
+
+        uint64_t v0 = z0;
+        uint64_t v1 = z0h ^ z2;
+        uint64_t v2 = z1 ^ z2h;
+        uint64_t v3 = z1h;
+
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+
+        // Reduction modulo x^128 + x^7 + x^2 + x + 1 (bit-reflected).
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        y0 = v2;
+        y1 = v3;
+    }
+    state.y0 = y0;
+    state.y1 = y1;
+}
+
+void GcmImpl::ctr(const unsigned char* j0, const unsigned char* in, unsigned char* out, std::size_t datalen) const {
+    // Four counter blocks per pass, matching the four lanes of the bitsliced AES.
+    unsigned char stream[4 * AesImpl::BLOCK_SIZE];
+    uint32_t counter = ((uint32_t)j0[12] << 24) | ((uint32_t)j0[13] << 16) | ((uint32_t)j0[14] << 8) | j0[15];
+    for (std::size_t done = 0; done < datalen; done += sizeof(stream)) {
+        std::size_t n = datalen - done < sizeof(stream) ? datalen - done : sizeof(stream);
+        std::size_t blocks = (n + AesImpl::BLOCK_SIZE - 1) / AesImpl::BLOCK_SIZE;
+        for (std::size_t i = 0; i < blocks; ++i) {
+            unsigned char* block = stream + AesImpl::BLOCK_SIZE * i;
+            uint32_t value = ++counter;
+            memcpy(block, j0, IV_SIZE);
+            block[12] = (unsigned char)(value >> 24);
+            block[13] = (unsigned char)(value >> 16);
+            block[14] = (unsigned char)(value >> 8);
+            block[15] = (unsigned char)value;
+        }
+        _aes.encryptBlocks(stream, stream, blocks);
+        for (std::size_t i = 0; i < n; ++i) out[done + i] = in[done + i] ^ stream[i];
+    }
+    secureZero(stream, sizeof(stream));
+}
+
+void GcmImpl::computeTag(const unsigned char* j0, const char* aad, std::size_t aadlen, const unsigned char* cipher,
+                         std::size_t datalen, unsigned char* tag) const {
+    Ghash state{0, 0};
+    ghashUpdate(state, reinterpret_cast<const unsigned char*>(aad), aadlen);
+    ghashUpdate(state, cipher, datalen);
+    finishTag(state, j0, aadlen, datalen, tag);
+}
+
+void GcmImpl::finishTag(Ghash& state, const unsigned char* j0, std::size_t aadlen, std::size_t datalen,
+                        unsigned char* tag) const {
+    unsigned char lengths[AesImpl::BLOCK_SIZE];
+    store64be(lengths, (uint64_t)aadlen * 8);
+    store64be(lengths + 8, (uint64_t)datalen * 8);
+    ghashUpdate(state, lengths, sizeof(lengths));
+
+    unsigned char mask[AesImpl::BLOCK_SIZE];
+    _aes.encryptBlocks(j0, mask, 1);
+    store64be(tag, state.y1);
+    store64be(tag + 8, state.y0);
+    for (std::size_t i = 0; i < TAG_SIZE; ++i) tag[i] ^= mask[i];
+    secureZero(mask, sizeof(mask));
+}
+
+std::string GcmImpl::encrypt(const char* iv, const char* aad, std::size_t aadlen, const char* data,
+                             std::size_t datalen, std::string& tag) const {
+    unsigned char j0[AesImpl::BLOCK_SIZE] = {0};
+    memcpy(j0, iv, IV_SIZE);
+    j0[15] = 1;
+    std::string result(datalen, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    ctr(j0, reinterpret_cast<const unsigned char*>(data), out, datalen);
+    tag.resize(TAG_SIZE);
+    computeTag(j0, aad, aadlen, out, datalen, reinterpret_cast<unsigned char*>(&tag[0]));
+    return result;
+}
+
+std::string GcmImpl::decrypt(const char* iv, const char* aad, std::size_t aadlen, const char* data,
+                             std::size_t datalen, const char* tag, std::size_t taglen) const {
+    if (!isValidTagSize(taglen)) {
+        throw std::runtime_error("Invalid AES-GCM tag length");
+    }
+    unsigned char j0[AesImpl::BLOCK_SIZE] = {0};
+    memcpy(j0, iv, IV_SIZE);
+    j0[15] = 1;
+    unsigned char expected[TAG_SIZE];
+    computeTag(j0, aad, aadlen, reinterpret_cast<const unsigned char*>(data), datalen, expected);
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < taglen; ++i) diff |= expected[i] ^ (unsigned char)tag[i];
+    if (diff != 0) {
+        throw std::runtime_error("AES-GCM tag mismatch");
+    }
+    std::string result(datalen, '\0');
+    ctr(j0, reinterpret_cast<const unsigned char*>(data), reinterpret_cast<unsigned char*>(&result[0]), datalen);
+    return result;
+}
+
+GcmImpl::Stream::Stream(const char* key, bool encrypt, const char* iv, const char* aad, std::size_t aadlen)
+    : _gcm(key), _encrypt(encrypt), _aadlen(aadlen) {
+    memset(_j0, 0, sizeof(_j0));
+    memcpy(_j0, iv, IV_SIZE);
+    _j0[15] = 1;
+    memcpy(_counter, _j0, sizeof(_counter));
+    _gcm.ghashUpdate(_ghash, reinterpret_cast<const unsigned char*>(aad), aadlen);
+}
+
+GcmImpl::Stream::~Stream() {
+    secureZero(&_ghash, sizeof(_ghash));
+    secureZero(_buffer, sizeof(_buffer));
+}
+
+// CTR over datalen bytes (whole blocks except on the last call) and GHASH over the ciphertext side.
+void GcmImpl::Stream::process(const unsigned char* in, unsigned char* out, std::size_t datalen) {
+    if (!_encrypt) {
+        _gcm.ghashUpdate(_ghash, in, datalen);
+    }
+    _gcm.ctr(_counter, in, out, datalen);
+    if (_encrypt) {
+        _gcm.ghashUpdate(_ghash, out, datalen);
+    }
+    uint32_t counter = ((uint32_t)_counter[12] << 24) | ((uint32_t)_counter[13] << 16) |
+                       ((uint32_t)_counter[14] << 8) | _counter[15];
+    counter += (uint32_t)((datalen + AesImpl::BLOCK_SIZE - 1) / AesImpl::BLOCK_SIZE);
+    _counter[12] = (unsigned char)(counter >> 24);
+    _counter[13] = (unsigned char)(counter >> 16);
+    _counter[14] = (unsigned char)(counter >> 8);
+    _counter[15] = (unsigned char)counter;
+    _datalen += datalen;
+}
+
+std::string GcmImpl::Stream::update(const char* data, std::size_t datalen) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    std::size_t blocks = (_buffered + datalen) / AesImpl::BLOCK_SIZE;
+    std::string result(blocks * AesImpl::BLOCK_SIZE, '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    if (blocks > 0 && _buffered > 0) {
+        std::size_t take = AesImpl::BLOCK_SIZE - _buffered;
+        memcpy(_buffer + _buffered, in, take);
+        process(_buffer, out, AesImpl::BLOCK_SIZE);
+        in += take;
+        datalen -= take;
+        out += AesImpl::BLOCK_SIZE;
+        --blocks;
+        _buffered = 0;
+    }
+    process(in, out, blocks * AesImpl::BLOCK_SIZE);
+    in += blocks * AesImpl::BLOCK_SIZE;
+    datalen -= blocks * AesImpl::BLOCK_SIZE;
+    if (datalen > 0) {
+        memcpy(_buffer + _buffered, in, datalen);
+        _buffered += datalen;
+    }
+    return result;
+}
+
+std::string GcmImpl::Stream::finish(std::string& tag) {
+    if (!_encrypt) {
+        throw std::runtime_error("AES-GCM decryption stream needs a tag");
+    }
+    std::string result(_buffered, '\0');
+    process(_buffer, reinterpret_cast<unsigned char*>(&result[0]), _buffered);
+    _buffered = 0;
+    tag.resize(TAG_SIZE);
+    _gcm.finishTag(_ghash, _j0, _aadlen, _datalen, reinterpret_cast<unsigned char*>(&tag[0]));
+    return result;
+}
+
+std::string GcmImpl::Stream::finish(const char* tag, std::size_t taglen) {
+    if (_encrypt) {
+        throw std::runtime_error("AES-GCM encryption stream produces the tag");
+    }
+    if (!isValidTagSize(taglen)) {
+        throw std::runtime_error("Invalid AES-GCM tag length");
+    }
+    std::string result(_buffered, '\0');
+    process(_buffer, reinterpret_cast<unsigned char*>(&result[0]), _buffered);
+    _buffered = 0;
+    unsigned char expected[TAG_SIZE];
+    _gcm.finishTag(_ghash, _j0, _aadlen, _datalen, expected);
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < taglen; ++i) diff |= expected[i] ^ (unsigned char)tag[i];
+    if (diff != 0) {
+        secureZero(&result[0], result.size());
+        throw std::runtime_error("AES-GCM tag mismatch");
+    }
+    return result;
+}
@@ -0,0 +1,426 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <algorithm>
+#include <privmx/drv/HashImpl.hpp>
+#include <stdexcept>
+
+namespace {
+
+inline uint32_t rotl32(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+inline uint32_t rotr32(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint64_t rotr64(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+inline uint32_t loadBe32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+inline uint64_t loadBe64(const unsigned char* p) {
+    return ((uint64_t)loadBe32(p) << 32) | loadBe32(p + 4);
+}
+
+inline uint32_t loadLe32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline void storeBe32(unsigned char* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+inline void storeBe64(unsigned char* p, uint64_t v) {
+    storeBe32(p, v >> 32);
+    storeBe32(p + 4, (uint32_t)v);
+}
+
+inline void storeLe32(unsigned char* p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+// Merkle-Damgard framing shared by all digests: block buffering and length padding.
+// Derived provides compress(blocks, count) and output(out).
+template<typename Derived, std::size_t BLOCK_SIZE, std::size_t DIGEST_SIZE, std::size_t LENGTH_SIZE,
+         bool LENGTH_BIG_ENDIAN>
+class BlockHash : public HashImpl {
+public:
+    void update(const unsigned char* data, std::size_t datalen) override {
+        _length += datalen;
+        if (_buffered > 0) {
+            std::size_t take = std::min(BLOCK_SIZE - _buffered, datalen);
+            memcpy(_buffer + _buffered, data, take);
+            _buffered += take;
+            data += take;
+            datalen -= take;
+            if (_buffered < BLOCK_SIZE) {
+                return;
+            }
+            self().compress(_buffer, 1);
+            _buffered = 0;
+        }
+        std::size_t blocks = datalen / BLOCK_SIZE;
+        if (blocks > 0) {
+            self().compress(data, blocks);
+            data += blocks * BLOCK_SIZE;
+            datalen -= blocks * BLOCK_SIZE;
+        }
+        if (datalen > 0) {
+            memcpy(_buffer, data, datalen);
+            _buffered = datalen;
+        }
+    }
+
+    void digest(unsigned char* out) override {
+        uint64_t bits = _length * 8;
+        _buffer[_buffered++] = 0x80;
+        if (_buffered > BLOCK_SIZE - LENGTH_SIZE) {
+            memset(_buffer + _buffered, 0, BLOCK_SIZE - _buffered);
+            self().compress(_buffer, 1);
+            _buffered = 0;
+        }
+        memset(_buffer + _buffered, 0, BLOCK_SIZE - _buffered);
+        for (std::size_t i = 0; i < 8; ++i) {
+            std::size_t pos = LENGTH_BIG_ENDIAN ? BLOCK_SIZE - 1 - i : BLOCK_SIZE - LENGTH_SIZE + i;
+            _buffer[pos] = (unsigned char)(bits >> (8 * i));
+        }
+        self().compress(_buffer, 1);
+        self().output(out);
+        memset(_buffer, 0, BLOCK_SIZE);
+    }
+
+    HashImpl::Ptr clone() const override { return std::make_unique<Derived>(self()); }
+    void restore(const HashImpl& obj) override { self() = static_cast<const Derived&>(obj); }
+    std::size_t digestSize() const override { return DIGEST_SIZE; }
+    std::size_t blockSize() const override { return BLOCK_SIZE; }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+    unsigned char _buffer[BLOCK_SIZE];
+    std::size_t _buffered = 0;
+    uint64_t _length = 0;
+};
+
+class Sha1 : public BlockHash<Sha1, 64, 20, 8, true> {
+public:
+    void compress(const unsigned char* block, std::size_t count) {
+        for (; count > 0; --count, block += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; ++i) w[i] = loadBe32(block + 4 * i);
+            for (int i = 16; i < 80; ++i) w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            uint32_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4];
+            for (int i = 0; i < 80; ++i) {
+                uint32_t f, k;
+                if (i < 20) {
+                    f = (b & c) | (~b & d);
+                    k = 0x5a827999;
+                } else if (i < 40) {
+                    f = b ^ c ^ d;
+                    k = 0x6ed9eba1;
+                } else if (i < 60) {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8f1bbcdc;
+                } else {
+                    f = b ^ c ^ d;
+                    k = 0xca62c1d6;
+                }
+                uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotl32(b, 30);
+                b = a;
+                a = t;
+            }
+            _h[0] += a;
+            _h[1] += b;
+            _h[2] += c;
+            _h[3] += d;
+            _h[4] += e;
+        }
+    }
+
+    void output(unsigned char* out) const {
+        for (int i = 0; i < 5; ++i) storeBe32(out + 4 * i, _h[i]);
+    }
+
+private:
+    uint32_t _h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+};
+
+const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+class Sha256 : public BlockHash<Sha256, 64, 32, 8, true> {
+public:
+    void compress(const unsigned char* block, std::size_t count) {
+        for (; count > 0; --count, block += 64) {
+            uint32_t w[64];
+            for (int i = 0; i < 16; ++i) w[i] = loadBe32(block + 4 * i);
+            for (int i = 16; i < 64; ++i) {
+                uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4], f = _h[5], g = _h[6], h = _h[7];
+            for (int i = 0; i < 64; ++i) {
+                uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+                uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+                uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            _h[0] += a;
+            _h[1] += b;
+            _h[2] += c;
+            _h[3] += d;
+            _h[4] += e;
+            _h[5] += f;
+            _h[6] += g;
+            _h[7] += h;
+        }
+    }
+
+    void output(unsigned char* out) const {
+        for (int i = 0; i < 8; ++i) storeBe32(out + 4 * i, _h[i]);
+    }
+
+private:
+    uint32_t _h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+};
+
+const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+class Sha512 : public BlockHash<Sha512, 128, 64, 16, true> {
+public:
+    void compress(const unsigned char* block, std::size_t count) {
+        for (; count > 0; --count, block += 128) {
+            uint64_t w[80];
+            for (int i = 0; i < 16; ++i) w[i] = loadBe64(block + 8 * i);
+            for (int i = 16; i < 80; ++i) {
+                uint64_t s0 = rotr64(w[i - 15], 1) ^ rotr64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+                uint64_t s1 = rotr64(w[i - 2], 19) ^ rotr64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint64_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4], f = _h[5], g = _h[6], h = _h[7];
+            for (int i = 0; i < 80; ++i) {
+                uint64_t s1 = rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41);
+                uint64_t t1 = h + s1 + ((e & f) ^ (~e & g)) + SHA512_K[i] + w[i];
+                uint64_t t2 = (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            _h[0] += a;
+            _h[1] += b;
+            _h[2] += c;
+            _h[3] += d;
+            _h[4] += e;
+            _h[5] += f;
+            _h[6] += g;
+            _h[7] += h;
+        }
+    }
+
+    void output(unsigned char* out) const {
+        for (int i = 0; i < 8; ++i) storeBe64(out + 8 * i, _h[i]);
+    }
+
+private:
+    uint64_t _h[8] = {0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+                      0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+};
+
+// RIPEMD-160 message word order, rotation amounts and round constants for the left and right lines.
+const uint8_t RMD_R[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13};
+const uint8_t RMD_RP[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11};
+const uint8_t RMD_S[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6};
+const uint8_t RMD_SP[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11};
+const uint32_t RMD_K[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+const uint32_t RMD_KP[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+inline uint32_t rmdF(int round, uint32_t x, uint32_t y, uint32_t z) {
+    switch (round) {
+        case 0:
+            return x ^ y ^ z;
+        case 1:
+            return (x & y) | (~x & z);
+        case 2:
+            return (x | ~y) ^ z;
+        case 3:
+            return (x & z) | (y & ~z);
+        default:
+            return x ^ (y | ~z);
+    }
+}
+
+class Ripemd160 : public BlockHash<Ripemd160, 64, 20, 8, false> {
+public:
+    void compress(const unsigned char* block, std::size_t count) {
+        for (; count > 0; --count, block += 64) {
+            uint32_t x[16];
+            for (int i = 0; i < 16; ++i) x[i] = loadLe32(block + 4 * i);
+            uint32_t al = _h[0], bl = _h[1], cl = _h[2], dl = _h[3], el = _h[4];
+            uint32_t ar = al, br = bl, cr = cl, dr = dl, er = el;
+            for (int i = 0; i < 80; ++i) {
+                int round = i / 16;
+                uint32_t t = rotl32(al + rmdF(round, bl, cl, dl) + x[RMD_R[i]] + RMD_K[round], RMD_S[i]) + el;
+                al = el;
+                el = dl;
+                dl = rotl32(cl, 10);
+                cl = bl;
+                bl = t;
+                t = rotl32(ar + rmdF(4 - round, br, cr, dr) + x[RMD_RP[i]] + RMD_KP[round], RMD_SP[i]) + er;
+                ar = er;
+                er = dr;
+                dr = rotl32(cr, 10);
+                cr = br;
+                br = t;
+            }
+            uint32_t t = _h[1] + cl + dr;
+            _h[1] = _h[2] + dl + er;
+            _h[2] = _h[3] + el + ar;
+            _h[3] = _h[4] + al + br;
+            _h[4] = _h[0] + bl + cr;
+            _h[0] = t;
+        }
+    }
+
+    void output(unsigned char* out) const {
+        for (int i = 0; i < 5; ++i) storeLe32(out + 4 * i, _h[i]);
+    }
+
+private:
+    uint32_t _h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+};
+
+}  // namespace
+
+HashImpl::Algorithm HashImpl::fromConfig(const char* config) {
+    if (strcmp(config, "SHA1") == 0) return Algorithm::SHA1;
+    if (strcmp(config, "SHA256") == 0) return Algorithm::SHA256;
+    if (strcmp(config, "SHA512") == 0) return Algorithm::SHA512;
+    if (strcmp(config, "RIPEMD160") == 0) return Algorithm::RIPEMD160;
+    throw std::runtime_error("Wrong hash config");
+}
+
+HashImpl::Ptr HashImpl::create(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::SHA1:
+            return std::make_unique<Sha1>();
+        case Algorithm::SHA256:
+            return std::make_unique<Sha256>();
+        case Algorithm::SHA512:
+            return std::make_unique<Sha512>();
+        case Algorithm::RIPEMD160:
+            return std::make_unique<Ripemd160>();
+    }
+    throw std::runtime_error("Wrong hash algorithm");
+}
+
+std::string HashImpl::digest(Algorithm algorithm, const char* data, std::size_t datalen) {
+    HashImpl::Ptr hash = create(algorithm);
+    hash->update(reinterpret_cast<const unsigned char*>(data), datalen);
+    return hash->digest();
+}
+
+std::size_t HashImpl::digestSize(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::SHA1:
+        case Algorithm::RIPEMD160:
+            return 20;
+        case Algorithm::SHA256:
+            return 32;
+        case Algorithm::SHA512:
+            return 64;
+    }
+    throw std::runtime_error("Wrong hash algorithm");
+}
+
+std::string HashImpl::digest() {
+    std::string result(digestSize(), '\0');
+    digest(reinterpret_cast<unsigned char*>(&result[0]));
+    return result;
+}
@@ -0,0 +1,75 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+
+#include <privmx/drv/HmacImpl.hpp>
+
+std::string HmacImpl::compute(HashImpl::Algorithm algorithm, const char* key, std::size_t keylen, const char* data,
+                              std::size_t datalen) {
+    HmacImpl hmac(algorithm, key, keylen);
+    hmac.update(data, datalen);
+    return hmac.digest();
+}
+
+HmacImpl::HmacImpl(HashImpl::Algorithm algorithm, const char* key, std::size_t keylen)
+    : _inner(HashImpl::create(algorithm)), _outer(HashImpl::create(algorithm)) {
+    std::size_t blockSize = _inner->blockSize();
+    unsigned char pad[128] = {0};
+    if (keylen > blockSize) {
+        HashImpl::Ptr keyHash = HashImpl::create(algorithm);
+        keyHash->update(reinterpret_cast<const unsigned char*>(key), keylen);
+        keyHash->digest(pad);
+    } else if (keylen > 0) {
+        memcpy(pad, key, keylen);
+    }
+    for (std::size_t i = 0; i < blockSize; ++i) pad[i] ^= 0x36;
+    _inner->update(pad, blockSize);
+    for (std::size_t i = 0; i < blockSize; ++i) pad[i] ^= 0x36 ^ 0x5c;
+    _outer->update(pad, blockSize);
+    memset(pad, 0, sizeof(pad));
+}
+
+HmacImpl::HmacImpl(const HmacImpl& obj) : _inner(obj._inner->clone()), _outer(obj._outer->clone()) {}
+
+HmacImpl& HmacImpl::operator=(const HmacImpl& obj) {
+    _inner = obj._inner->clone();
+    _outer = obj._outer->clone();
+    return *this;
+}
+
+void HmacImpl::reset(const HmacImpl& obj) {
+    _inner->restore(*obj._inner);
+    _outer->restore(*obj._outer);
+}
+
+void HmacImpl::update(const char* data, std::size_t datalen) {
+    _inner->update(reinterpret_cast<const unsigned char*>(data), datalen);
+}
+
+void HmacImpl::digest(unsigned char* out) {
+    unsigned char innerDigest[64];
+    std::size_t size = _inner->digestSize();
+    _inner->digest(innerDigest);
+    _outer->update(innerDigest, size);
+    _outer->digest(out);
+    memset(innerDigest, 0, sizeof(innerDigest));
+}
+
+std::string HmacImpl::digest() {
+    std::string result(digestSize(), '\0');
+    digest(reinterpret_cast<unsigned char*>(&result[0]));
+    return result;
+}
+
+std::size_t HmacImpl::digestSize() const {
+    return _outer->digestSize();
+}
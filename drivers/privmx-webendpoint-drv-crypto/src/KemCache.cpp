@@ -0,0 +1,117 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+#include <unistd.h>
+
+#include <privmx/drv/HmacImpl.hpp>
+#include <privmx/drv/KemCache.hpp>
+
+namespace {
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+}  // namespace
+
+KemCache& KemCache::getInstance() {
+    static KemCache instance;
+    return instance;
+}
+
+KemCache::KemCache() {
+    // Without a random salt fingerprints could be precomputed, so the cache stays disabled
+    if (getentropy(_salt, sizeof(_salt)) != 0) {
+        _capacity = 0;
+    }
+}
+
+void KemCache::get(const char* key, std::size_t keylen, unsigned char* kem) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_capacity == 0) {
+        ++_misses;
+        lock.unlock();
+        CbcHmacImpl::deriveKem(key, keylen, kem);
+        return;
+    }
+    std::string id = fingerprint(key, keylen);
+    auto found = _index.find(id);
+    if (found != _index.end()) {
+        ++_hits;
+        _entries.splice(_entries.begin(), _entries, found->second);
+        memcpy(kem, found->second->kem, CbcHmacImpl::KEM_SIZE);
+        return;
+    }
+    ++_misses;
+    lock.unlock();
+    CbcHmacImpl::deriveKem(key, keylen, kem);
+    lock.lock();
+    // Another thread may have derived the same key meanwhile, or the cache may have been disabled
+    if (_capacity == 0 || _index.count(id) > 0) {
+        return;
+    }
+    _entries.emplace_front();
+    _entries.front().fingerprint = id;
+    memcpy(_entries.front().kem, kem, CbcHmacImpl::KEM_SIZE);
+    _index[id] = _entries.begin();
+    _evictions += shrink(_capacity);
+}
+
+CbcHmacImpl KemCache::cbcHmac(const char* key, std::size_t keylen) {
+    unsigned char kem[CbcHmacImpl::KEM_SIZE];
+    get(key, keylen, kem);
+    CbcHmacImpl result(kem);
+    secureZero(kem, sizeof(kem));
+    return result;
+}
+
+void KemCache::setCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    _evictions += shrink(_capacity);
+}
+
+void KemCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    shrink(0);
+}
+
+KemCache::Stats KemCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Stats{_hits, _misses, _evictions, _entries.size(), _capacity};
+}
+
+void KemCache::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+std::string KemCache::fingerprint(const char* key, std::size_t keylen) const {
+    HmacImpl hmac(HashImpl::Algorithm::SHA256, reinterpret_cast<const char*>(_salt), sizeof(_salt));
+    hmac.update(key, keylen);
+    return hmac.digest();
+}
+
+// Drops least recently used entries down to capacity and returns their number; _mutex must be held.
+std::size_t KemCache::shrink(std::size_t capacity) {
+    std::size_t dropped = 0;
+    for (; _entries.size() > capacity; ++dropped) {
+        Entry& last = _entries.back();
+        secureZero(last.kem, sizeof(last.kem));
+        _index.erase(last.fingerprint);
+        _entries.pop_back();
+    }
+    return dropped;
+}
@@ -0,0 +1,102 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <strings.h>
+
+#include <algorithm>
+#include <privmx/drv/HmacImpl.hpp>
+#include <privmx/drv/Pbkdf2Impl.hpp>
+#include <stdexcept>
+
+namespace {
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+}  // namespace
+
+HashImpl::Algorithm Pbkdf2Impl::fromConfig(const char* hash) {
+    if (strcasecmp(hash, "sha1") == 0) return HashImpl::Algorithm::SHA1;
+    if (strcasecmp(hash, "sha256") == 0) return HashImpl::Algorithm::SHA256;
+    if (strcasecmp(hash, "sha512") == 0) return HashImpl::Algorithm::SHA512;
+    throw std::runtime_error("Wrong pbkdf2 hash config");
+}
+
+bool Pbkdf2Impl::isUtf8(const char* data, std::size_t len) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    std::size_t i = 0;
+    while (i < len) {
+        unsigned char c = p[i];
+        std::size_t extra;
+        // Bounds of the first continuation byte, which rule out overlong forms, surrogates and > U+10FFFF
+        unsigned char low = 0x80, high = 0xbf;
+        if (c < 0x80) {
+            ++i;
+            continue;
+        } else if (c >= 0xc2 && c <= 0xdf) {
+            extra = 1;
+        } else if (c >= 0xe0 && c <= 0xef) {
+            extra = 2;
+            if (c == 0xe0) low = 0xa0;
+            if (c == 0xed) high = 0x9f;
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            extra = 3;
+            if (c == 0xf0) low = 0x90;
+            if (c == 0xf4) high = 0x8f;
+        } else {
+            return false;
+        }
+        if (len - i <= extra || p[i + 1] < low || p[i + 1] > high) {
+            return false;
+        }
+        for (std::size_t j = 2; j <= extra; ++j) {
+            if ((p[i + j] & 0xc0) != 0x80) {
+                return false;
+            }
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+std::string Pbkdf2Impl::derive(HashImpl::Algorithm algorithm, const char* pass, std::size_t passlen,
+                               const char* salt, std::size_t saltlen, std::size_t rounds, std::size_t length) {
+    if (rounds == 0) {
+        throw std::runtime_error("Invalid pbkdf2 rounds");
+    }
+    HmacImpl keyed(algorithm, pass, passlen);
+    HmacImpl hmac(keyed);
+    const std::size_t size = hmac.digestSize();
+    std::string result(length, '\0');
+    unsigned char u[64];
+    unsigned char t[64];
+    for (uint32_t block = 1; (std::size_t)(block - 1) * size < length; ++block) {
+        const char index[4] = {(char)(block >> 24), (char)(block >> 16), (char)(block >> 8), (char)block};
+        hmac.reset(keyed);
+        hmac.update(salt, saltlen);
+        hmac.update(index, sizeof(index));
+        hmac.digest(u);
+        std::copy(u, u + size, t);
+        for (std::size_t round = 1; round < rounds; ++round) {
+            hmac.reset(keyed);
+            hmac.update(reinterpret_cast<const char*>(u), size);
+            hmac.digest(u);
+            for (std::size_t i = 0; i < size; ++i) t[i] ^= u[i];
+        }
+        std::size_t offset = (block - 1) * size;
+        std::copy(t, t + std::min(size, length - offset), &result[offset]);
+    }
+    secureZero(u, sizeof(u));
+    secureZero(t, sizeof(t));
+    return result;
+}
@@ -0,0 +1,93 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <privmx/drv/RandomPool.hpp>
+
+namespace {
+
+// getentropy() is specified for at most 256 bytes per call
+const std::size_t ENTROPY_CHUNK = 256;
+
+std::atomic<uint64_t> pooledCalls{0};
+std::atomic<uint64_t> directCalls{0};
+std::atomic<uint64_t> refills{0};
+std::atomic<uint64_t> fallbacks{0};
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+bool entropy(unsigned char* out, std::size_t len) {
+    for (std::size_t done = 0; done < len; done += ENTROPY_CHUNK) {
+        if (getentropy(out + done, std::min(ENTROPY_CHUNK, len - done)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Pool {
+    ~Pool() { secureZero(bytes, sizeof(bytes)); }
+
+    unsigned char bytes[RandomPool::POOL_SIZE];
+    // Bytes before pos were served (and wiped) already.
+    std::size_t pos = RandomPool::POOL_SIZE;
+};
+
+thread_local Pool pool;
+
+}  // namespace
+
+bool RandomPool::fill(char* buf, std::size_t len) {
+    unsigned char* out = reinterpret_cast<unsigned char*>(buf);
+    if (len > MAX_POOLED) {
+        directCalls.fetch_add(1, std::memory_order_relaxed);
+        return entropy(out, len);
+    }
+    pooledCalls.fetch_add(1, std::memory_order_relaxed);
+    while (len > 0) {
+        if (pool.pos == POOL_SIZE) {
+            if (!entropy(pool.bytes, POOL_SIZE)) {
+                return false;
+            }
+            pool.pos = 0;
+            refills.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::size_t take = std::min(len, POOL_SIZE - pool.pos);
+        memcpy(out, pool.bytes + pool.pos, take);
+        secureZero(pool.bytes + pool.pos, take);
+        pool.pos += take;
+        out += take;
+        len -= take;
+    }
+    return true;
+}
+
+void RandomPool::recordFallback() {
+    fallbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+RandomPool::Stats RandomPool::getStats() {
+    return Stats{pooledCalls.load(), directCalls.load(), refills.load(), fallbacks.load()};
+}
+
+void RandomPool::resetStats() {
+    pooledCalls = 0;
+    directCalls = 0;
+    refills = 0;
+    fallbacks = 0;
+}
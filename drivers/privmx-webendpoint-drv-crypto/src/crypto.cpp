@@ -12,15 +12,28 @@ limitations under the License.
 #include "privmx/drv/crypto.h"
 
 #include <Poco/Dynamic/Var.h>
+#include <Poco/JSON/Array.h>
 #include <Poco/JSON/Object.h>
 #include <emscripten.h>
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <Pson/BinaryString.hpp>
+#include <privmx/drv/AesImpl.hpp>
+#include <privmx/drv/CbcHmacImpl.hpp>
+#include <privmx/drv/CryptoDispatch.hpp>
+#include <privmx/drv/GcmImpl.hpp>
+#include <privmx/drv/HashImpl.hpp>
+#include <privmx/drv/HmacImpl.hpp>
+#include <privmx/drv/KemCache.hpp>
+#include <privmx/drv/Pbkdf2Impl.hpp>
+#include <privmx/drv/RandomPool.hpp>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "AsyncEngine.hpp"
 #include "Mapper.hpp"
@@ -36,24 +49,76 @@ emscripten::memory_view<unsigned char> createUint8Array(const char* data, size_t
 
 // clang-format off
 
+EM_JS_DEPS(privmxDrvCrypto, "$UTF8ToString,malloc");
+
 EM_JS(void, performCryptoCall, (const char* method_str, emscripten::EM_VAL params_handle, int callId), {
     let method = UTF8ToString(method_str);
     let params = Emval.toValue(params_handle);
     Promise.resolve(self['em_crypto'].methodCaller(method, params))
     .then((response) => {
-        let ret = {status: 1, buff: new Uint8Array(response), error: ""};
+        // The result is written straight into a heap buffer which becomes the caller's *out
+        let bytes = ArrayBuffer.isView(response)
+            ? new Uint8Array(response.buffer, response.byteOffset, response.byteLength)
+            : new Uint8Array(response);
+        let ptr = _malloc(Math.max(bytes.length, 1));
+        if (!ptr) {
+            throw new Error("Out of memory");
+        }
+        HEAPU8.set(bytes, ptr);
+        let ret = {status: 1, ptr: ptr, len: bytes.length, error: ""};
+        Module.ccall('AsyncEngine_onSuccess', null, ['number', 'number'], [callId, Emval.toHandle(ret)]);
+    })
+    .catch((error) => {
+        console.error("Crypto Error [" + method + "]", error);
+        let ret = {status: -1, ptr: 0, len: 0, error: error.toString()};
+        Module.ccall('AsyncEngine_onError', null, ['number', 'number'], [callId, Emval.toHandle(ret)]);
+    });
+});
+
+// Runs one EmCrypto method over an array of params objects; results are reported per item as heap
+// buffers (ptrs[i], lens[i]), a failed item has ptr 0 and len -1.
+EM_JS(void, performCryptoBatchCall, (const char* method_str, emscripten::EM_VAL items_handle, int callId), {
+    let method = UTF8ToString(method_str);
+    let items = Emval.toValue(items_handle);
+    Promise.allSettled(items.map((params) => self['em_crypto'].methodCaller(method, params)))
+    .then((results) => {
+        let ptrs = [];
+        let lens = [];
+        for (const result of results) {
+            if (result.status !== "fulfilled") {
+                console.error("Crypto Error [" + method + "]", result.reason);
+                ptrs.push(0);
+                lens.push(-1);
+                continue;
+            }
+            let response = result.value;
+            let bytes = ArrayBuffer.isView(response)
+                ? new Uint8Array(response.buffer, response.byteOffset, response.byteLength)
+                : new Uint8Array(response);
+            let ptr = _malloc(Math.max(bytes.length, 1));
+            if (!ptr) {
+                ptrs.push(0);
+                lens.push(-1);
+                continue;
+            }
+            HEAPU8.set(bytes, ptr);
+            ptrs.push(ptr);
+            lens.push(bytes.length);
+        }
+        let ret = {status: 1, ptrs: ptrs, lens: lens, error: ""};
         Module.ccall('AsyncEngine_onSuccess', null, ['number', 'number'], [callId, Emval.toHandle(ret)]);
     })
     .catch((error) => {
         console.error("Crypto Error [" + method + "]", error);
-        let ret = {status: -1, buff: "", error: error.toString()};
+        let ret = {status: -1, ptrs: [], lens: [], error: error.toString()};
         Module.ccall('AsyncEngine_onError', null, ['number', 'number'], [callId, Emval.toHandle(ret)]);
     });
 });
 
 // clang-format on
 
-std::string extractCryptoResult(std::future<Poco::Dynamic::Var>& future) {
+// Hands over the malloc'ed heap buffer the JS side wrote the result into; release it with free().
+void extractCryptoResult(std::future<Poco::Dynamic::Var>& future, char** out, unsigned int* outlen) {
     Poco::Dynamic::Var resultVar = future.get();
     Poco::JSON::Object::Ptr obj = resultVar.extract<Poco::JSON::Object::Ptr>();
 
@@ -61,7 +126,8 @@ std::string extractCryptoResult(std::future<Poco::Dynamic::Var>& future) {
     if (status < 0) {
         throw std::runtime_error(obj->getValue<std::string>("error"));
     }
-    return obj->getValue<Pson::BinaryString>("buff");
+    *out = reinterpret_cast<char*>(static_cast<uintptr_t>(obj->getValue<Poco::Int64>("ptr")));
+    *outlen = obj->getValue<unsigned int>("len");
 }
 
 // clang-format off
@@ -74,7 +140,8 @@ EM_JS(bool,checkIfWorker,(void),{
     }
 });
 
-std::string hmac(const std::string& engine, const char* key, unsigned int keylen, const char* data, int datalen){
+void hmac(const std::string& engine, const char* key, unsigned int keylen, const char* data, int datalen, char** out,
+          unsigned int* outlen) {
     auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
         val params = val::object();
         params.set("engine", engine);
@@ -85,7 +152,7 @@ std::string hmac(const std::string& engine, const char* key, unsigned int keylen
         },
         CRYPTO_THREAD);
 
-    return extractCryptoResult(future);
+    extractCryptoResult(future, out, outlen);
 }
 
 std::string translateAESConfig(const char* config) {
@@ -109,6 +176,10 @@ int privmxDrvCrypto_version(unsigned int* version) {
 }
 
 int privmxDrvCrypto_randomBytes(char* buf, unsigned int len) {
+    if (RandomPool::fill(buf, len)) {
+        return 0;
+    }
+    RandomPool::recordFallback();
     auto future = AsyncEngine::getInstance()->callJsAsync(
         [len](int callId) {
             val params = val::object();
@@ -118,15 +189,37 @@ int privmxDrvCrypto_randomBytes(char* buf, unsigned int len) {
         CRYPTO_THREAD);
 
     try {
-        std::string res = extractCryptoResult(future);
-        memcpy(buf, res.data(), len);
-        return 0;
+        char* res;
+        unsigned int reslen;
+        extractCryptoResult(future, &res, &reslen);
+        memcpy(buf, res, reslen < len ? reslen : len);
+        free(res);
+        return reslen < len ? 1 : 0;
     } catch (...) {
         return 1;
     }
 }
 
+void writeResult(const std::string& res, char** out, unsigned int* outlen) {
+    *out = reinterpret_cast<char*>(malloc(res.size()));
+    *outlen = res.size();
+    memcpy(*out, res.data(), res.size());
+}
+
 int privmxDrvCrypto_md(const char* data, int datalen, const char* config, char** out, unsigned int* outlen) {
+    try {
+        HashImpl::Algorithm algorithm = HashImpl::fromConfig(config);
+        // RIPEMD-160 has no WebCrypto backend, its JS fallback is slower than wasm at any size
+        bool preferNative = algorithm == HashImpl::Algorithm::RIPEMD160;
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::MD, datalen, preferNative);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::MD, native, datalen);
+        if (native) {
+            writeResult(HashImpl::digest(algorithm, data, datalen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
     std::string str_config = translateSHAConfig(config);
 
     auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
@@ -136,10 +229,7 @@ int privmxDrvCrypto_md(const char* data, int datalen, const char* config, char**
     }, CRYPTO_THREAD);
 
     try {
-        std::string res = extractCryptoResult(future);
-        *out = reinterpret_cast<char*>(malloc(res.size()));
-        *outlen = res.size();
-        memcpy(*out, res.data(), res.size());
+        extractCryptoResult(future, out, outlen);
         return 0;
     } catch (...) {
         return 1;
@@ -148,12 +238,20 @@ int privmxDrvCrypto_md(const char* data, int datalen, const char* config, char**
 
 int privmxDrvCrypto_hmac(const char* key, unsigned int keylen, const char* data, int datalen, const char* config,
                          char** out, unsigned int* outlen) {
+    try {
+        HashImpl::Algorithm algorithm = HashImpl::fromConfig(config);
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::HMAC, datalen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::HMAC, native, datalen);
+        if (native) {
+            writeResult(HmacImpl::compute(algorithm, key, keylen, data, datalen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
     std::string str_config = translateSHAConfig(config);
     try {
-        std::string res = hmac(str_config, key, keylen, data, datalen);
-        *out = reinterpret_cast<char*>(malloc(res.size()));
-        *outlen = res.size();
-        memcpy(*out, res.data(), res.size());
+        hmac(str_config, key, keylen, data, datalen, out, outlen);
         return 0;
     } catch (std::exception& e) {
         std::cerr << "_Hmac exception: " << e.what() << std::endl;
@@ -161,8 +259,25 @@ int privmxDrvCrypto_hmac(const char* key, unsigned int keylen, const char* data,
     }
 }
 
+bool useNativeAes(AesImpl::Mode mode, unsigned int datalen) {
+    // Only AES-256-CBC has a WebCrypto backend, the other configs run on crypto-browserify
+    bool preferNative = mode != AesImpl::Mode::CBC_PKCS7;
+    bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::AES, datalen, preferNative);
+    CryptoDispatch::getInstance().record(CryptoDispatch::Op::AES, native, datalen);
+    return native;
+}
+
 int privmxDrvCrypto_aesEncrypt(const char* key, const char* iv, const char* data, unsigned int datalen,
                                const char* config, char** out, unsigned int* outlen) {
+    try {
+        AesImpl::Mode mode = AesImpl::fromConfig(config);
+        if (useNativeAes(mode, datalen)) {
+            writeResult(AesImpl(key).encrypt(mode, iv, data, datalen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
     std::string str_config = translateAESConfig(config);
     
     auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
@@ -178,10 +293,7 @@ int privmxDrvCrypto_aesEncrypt(const char* key, const char* iv, const char* data
     }, CRYPTO_THREAD);
 
     try {
-        std::string res = extractCryptoResult(future);
-        *out = reinterpret_cast<char*>(malloc(res.size()));
-        *outlen = res.size();
-        memcpy(*out, res.data(), res.size());
+        extractCryptoResult(future, out, outlen);
         return 0;
     } catch (...) {
         return 1;
@@ -197,12 +309,60 @@ int privmxDrvCrypto_aeadEncrypt(
     char** out, unsigned int* outlen,
     char** tag, unsigned int* taglen
 ) {
-    // not supported
-    return 1;
+    try {
+        GcmImpl::checkConfig(config);
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::AEAD, datalen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::AEAD, native, datalen);
+        if (native) {
+            std::string resTag;
+            writeResult(GcmImpl(key).encrypt(iv, aad, aadlen, data, datalen, resTag), out, outlen);
+            writeResult(resTag, tag, taglen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
+
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val params = val::object();
+        params.set("data", createUint8Array(data, datalen));
+        params.set("key", createUint8Array(key, 32));
+        params.set("iv", createUint8Array(iv, GcmImpl::IV_SIZE));
+        params.set("aad", createUint8Array(aad, aadlen));
+        performCryptoCall("aes256GcmEncrypt", params.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    // The caller gets no ciphertext unless it gets the tag as well
+    *out = nullptr;
+    *outlen = 0;
+    try {
+        // WebCrypto appends the tag to the ciphertext; the ciphertext part is handed over in place
+        extractCryptoResult(future, out, outlen);
+        if (*outlen != datalen + GcmImpl::TAG_SIZE) {
+            throw std::runtime_error("Unexpected aes256GcmEncrypt result length");
+        }
+        writeResult(std::string(*out + datalen, GcmImpl::TAG_SIZE), tag, taglen);
+        *outlen = datalen;
+        return 0;
+    } catch (...) {
+        free(*out);
+        *out = nullptr;
+        *outlen = 0;
+        return 1;
+    }
 }
 
 int privmxDrvCrypto_aesDecrypt(const char* key, const char* iv, const char* data, unsigned int datalen,
                                const char* config, char** out, unsigned int* outlen) {
+    try {
+        AesImpl::Mode mode = AesImpl::fromConfig(config);
+        if (useNativeAes(mode, datalen)) {
+            writeResult(AesImpl(key).decrypt(mode, iv, data, datalen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
     std::string str_config = translateAESConfig(config);
 
     auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
@@ -218,10 +378,7 @@ int privmxDrvCrypto_aesDecrypt(const char* key, const char* iv, const char* data
     }, CRYPTO_THREAD);
 
     try {
-        std::string res = extractCryptoResult(future);
-        *out = reinterpret_cast<char*>(malloc(res.size()));
-        *outlen = res.size();
-        memcpy(*out, res.data(), res.size());
+        extractCryptoResult(future, out, outlen);
         return 0;
     } catch (...) {
         return 1;
@@ -237,11 +394,125 @@ int privmxDrvCrypto_aeadDecrypt(
     const char* config,
     char** out, unsigned int* outlen
 ) {
-    // not supported
-    return 1;
+    try {
+        GcmImpl::checkConfig(config);
+        if (!GcmImpl::isValidTagSize(taglen)) {
+            return 1;
+        }
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::AEAD, datalen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::AEAD, native, datalen);
+        if (native) {
+            writeResult(GcmImpl(key).decrypt(iv, aad, aadlen, data, datalen, tag, taglen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
+
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val params = val::object();
+        params.set("data", createUint8Array(data, datalen));
+        params.set("key", createUint8Array(key, 32));
+        params.set("iv", createUint8Array(iv, GcmImpl::IV_SIZE));
+        params.set("aad", createUint8Array(aad, aadlen));
+        params.set("tag", createUint8Array(tag, taglen));
+        performCryptoCall("aes256GcmDecrypt", params.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    try {
+        extractCryptoResult(future, out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aes256CbcHmac256Encrypt(const char* key, unsigned int keylen, const char* iv, const char* data,
+                                            unsigned int datalen, unsigned int taglen, char** out,
+                                            unsigned int* outlen) {
+    try {
+        if (!CbcHmacImpl::isValidTagSize(taglen)) {
+            return 1;
+        }
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::CBC_HMAC, datalen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::CBC_HMAC, native, datalen);
+        if (native) {
+            CbcHmacImpl impl = KemCache::getInstance().cbcHmac(key, keylen);
+            writeResult(impl.encrypt(iv, data, datalen, taglen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
+
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val params = val::object();
+        params.set("data", createUint8Array(data, datalen));
+        params.set("key", createUint8Array(key, keylen));
+        params.set("iv", createUint8Array(iv, AesImpl::BLOCK_SIZE));
+        params.set("taglen", taglen);
+        performCryptoCall("aes256CbcHmac256Encrypt", params.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    try {
+        extractCryptoResult(future, out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aes256CbcHmac256Decrypt(const char* key, unsigned int keylen, const char* data,
+                                            unsigned int datalen, unsigned int taglen, char** out,
+                                            unsigned int* outlen) {
+    try {
+        if (!CbcHmacImpl::isValidTagSize(taglen)) {
+            return 1;
+        }
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::CBC_HMAC, datalen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::CBC_HMAC, native, datalen);
+        if (native) {
+            CbcHmacImpl impl = KemCache::getInstance().cbcHmac(key, keylen);
+            writeResult(impl.decrypt(data, datalen, taglen), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
+
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val params = val::object();
+        params.set("data", createUint8Array(data, datalen));
+        params.set("key", createUint8Array(key, keylen));
+        params.set("taglen", taglen);
+        performCryptoCall("aes256CbcHmac256Decrypt", params.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    try {
+        extractCryptoResult(future, out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
 int privmxDrvCrypto_pbkdf2(const char* pass, unsigned int passlen, const char* salt, unsigned int saltlen, int rounds, unsigned int length, const char* hash, char** out, unsigned int* outlen){
+    try {
+        HashImpl::Algorithm algorithm = Pbkdf2Impl::fromConfig(hash);
+        if (rounds <= 0) {
+            return 1;
+        }
+        // Anything but UTF-8 derives in JS, which replaces invalid sequences, so existing keys stay the same
+        bool native = CryptoDispatch::getInstance().useNative(CryptoDispatch::Op::PBKDF2, rounds) &&
+                      Pbkdf2Impl::isUtf8(pass, passlen) && Pbkdf2Impl::isUtf8(salt, saltlen);
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::PBKDF2, native, rounds);
+        if (native) {
+            writeResult(Pbkdf2Impl::derive(algorithm, pass, passlen, salt, saltlen, rounds, length), out, outlen);
+            return 0;
+        }
+    } catch (...) {
+        return 1;
+    }
     auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
         val params = val::object();
         params.set("password", std::string(pass,passlen));
@@ -254,16 +525,429 @@ int privmxDrvCrypto_pbkdf2(const char* pass, unsigned int passlen, const char* s
     }, CRYPTO_THREAD);
 
     try {
-        std::string res = extractCryptoResult(future);
-        *out = reinterpret_cast<char*>(malloc(res.size()));
-        *outlen = res.size();
-        memcpy(*out, res.data(), res.size());
+        extractCryptoResult(future, out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_mdInit(const char* config, void** ctx) {
+    if (!ctx) {
+        return 1;
+    }
+    try {
+        *ctx = HashImpl::create(HashImpl::fromConfig(config)).release();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_mdUpdate(void* ctx, const char* data, unsigned int datalen) {
+    if (!ctx || (!data && datalen > 0)) {
+        return 1;
+    }
+    try {
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::MD, true, datalen);
+        static_cast<HashImpl*>(ctx)->update(reinterpret_cast<const unsigned char*>(data), datalen);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
+int privmxDrvCrypto_mdFinal(void* ctx, char** out, unsigned int* outlen) {
+    HashImpl::Ptr hash(static_cast<HashImpl*>(ctx));
+    if (!hash || !out || !outlen) {
+        return 1;
+    }
+    try {
+        writeResult(hash->digest(), out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_mdFree(void* ctx) {
+    delete static_cast<HashImpl*>(ctx);
+    return 0;
+}
+
+int privmxDrvCrypto_aesInit(const char* key, const char* iv, const char* config, int encrypt, void** ctx) {
+    if (!ctx) {
+        return 1;
+    }
+    try {
+        *ctx = new AesImpl::CbcStream(key, AesImpl::fromConfig(config), encrypt != 0, iv);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aesUpdate(void* ctx, const char* data, unsigned int datalen, char** out, unsigned int* outlen) {
+    if (!ctx || (!data && datalen > 0) || !out || !outlen) {
+        return 1;
+    }
+    try {
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::AES, true, datalen);
+        writeResult(static_cast<AesImpl::CbcStream*>(ctx)->update(data, datalen), out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aesFinal(void* ctx, char** out, unsigned int* outlen) {
+    std::unique_ptr<AesImpl::CbcStream> stream(static_cast<AesImpl::CbcStream*>(ctx));
+    if (!stream || !out || !outlen) {
+        return 1;
+    }
+    try {
+        writeResult(stream->finish(), out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aesFree(void* ctx) {
+    delete static_cast<AesImpl::CbcStream*>(ctx);
+    return 0;
+}
+
+int privmxDrvCrypto_aeadInit(const char* key, const char* iv, const char* aad, unsigned int aadlen, const char* config,
+                             int encrypt, void** ctx) {
+    if (!ctx) {
+        return 1;
+    }
+    try {
+        GcmImpl::checkConfig(config);
+        *ctx = new GcmImpl::Stream(key, encrypt != 0, iv, aad, aadlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aeadUpdate(void* ctx, const char* data, unsigned int datalen, char** out, unsigned int* outlen) {
+    if (!ctx || (!data && datalen > 0) || !out || !outlen) {
+        return 1;
+    }
+    try {
+        CryptoDispatch::getInstance().record(CryptoDispatch::Op::AEAD, true, datalen);
+        writeResult(static_cast<GcmImpl::Stream*>(ctx)->update(data, datalen), out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aeadEncryptFinal(void* ctx, char** out, unsigned int* outlen, char** tag, unsigned int* taglen) {
+    std::unique_ptr<GcmImpl::Stream> stream(static_cast<GcmImpl::Stream*>(ctx));
+    if (!stream || !out || !outlen || !tag || !taglen) {
+        return 1;
+    }
+    try {
+        std::string resTag;
+        std::string result = stream->finish(resTag);
+        writeResult(result, out, outlen);
+        writeResult(resTag, tag, taglen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aeadDecryptFinal(void* ctx, const char* tag, unsigned int taglen, char** out,
+                                     unsigned int* outlen) {
+    std::unique_ptr<GcmImpl::Stream> stream(static_cast<GcmImpl::Stream*>(ctx));
+    if (!stream || (!tag && taglen > 0) || !out || !outlen) {
+        return 1;
+    }
+    try {
+        writeResult(stream->finish(tag, taglen), out, outlen);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int privmxDrvCrypto_aeadFree(void* ctx) {
+    delete static_cast<GcmImpl::Stream*>(ctx);
+    return 0;
+}
+
+// Constant-time comparison of two keys, used to reuse prepared key state between batch items.
+bool sameKey(const char* a, unsigned int alen, const char* b, unsigned int blen) {
+    if (alen != blen) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (unsigned int i = 0; i < alen; ++i) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+// Shared driver of the batch entry points. Items the dispatch policy keeps native run in one loop on
+// the calling thread, all the others go to the crypto thread in a single round trip. A failed item
+// leaves outs[i] == nullptr; the return value is 1 if any item failed.
+int runBatch(CryptoDispatch::Op op, unsigned int count, const unsigned int* datalens, bool preferNative,
+             const std::function<std::string(unsigned int)>& native, const std::string& jsMethod,
+             const std::function<void(unsigned int, val&)>& setJsParams, char** outs, unsigned int* outlens) {
+    CryptoDispatch& dispatch = CryptoDispatch::getInstance();
+    std::vector<unsigned int> deferred;
+    int failed = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        outs[i] = nullptr;
+        outlens[i] = 0;
+        bool isNative = dispatch.useNative(op, datalens[i], preferNative);
+        dispatch.record(op, isNative, datalens[i]);
+        if (!isNative) {
+            deferred.push_back(i);
+            continue;
+        }
+        try {
+            writeResult(native(i), &outs[i], &outlens[i]);
+        } catch (...) {
+            failed = 1;
+        }
+    }
+    if (deferred.empty()) {
+        return failed;
+    }
+
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val items = val::array();
+        for (unsigned int i : deferred) {
+            val params = val::object();
+            setJsParams(i, params);
+            items.call<void>("push", params);
+        }
+        performCryptoBatchCall(jsMethod.c_str(), items.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    try {
+        Poco::JSON::Object::Ptr obj = future.get().extract<Poco::JSON::Object::Ptr>();
+        Poco::JSON::Array::Ptr ptrs = obj->getArray("ptrs");
+        Poco::JSON::Array::Ptr lens = obj->getArray("lens");
+        for (std::size_t k = 0; k < deferred.size(); ++k) {
+            Poco::Int64 len = lens->getElement<Poco::Int64>(k);
+            if (len < 0) {
+                failed = 1;
+                continue;
+            }
+            outs[deferred[k]] = reinterpret_cast<char*>(static_cast<uintptr_t>(ptrs->getElement<Poco::Int64>(k)));
+            outlens[deferred[k]] = len;
+        }
+    } catch (...) {
+        failed = 1;
+    }
+    return failed;
+}
+
+int privmxDrvCrypto_mdBatch(const char* const* data, const unsigned int* datalens, unsigned int count,
+                            const char* config, char** outs, unsigned int* outlens) {
+    HashImpl::Algorithm algorithm;
+    std::string str_config;
+    try {
+        algorithm = HashImpl::fromConfig(config);
+        str_config = translateSHAConfig(config);
+    } catch (...) {
+        return 1;
+    }
+    bool preferNative = algorithm == HashImpl::Algorithm::RIPEMD160;
+    return runBatch(
+        CryptoDispatch::Op::MD, count, datalens, preferNative,
+        [&](unsigned int i) { return HashImpl::digest(algorithm, data[i], datalens[i]); }, str_config,
+        [=](unsigned int i, val& params) { params.set("data", createUint8Array(data[i], datalens[i])); }, outs,
+        outlens);
+}
+
+int privmxDrvCrypto_hmacBatch(const char* const* keys, const unsigned int* keylens, const char* const* data,
+                              const unsigned int* datalens, unsigned int count, const char* config, char** outs,
+                              unsigned int* outlens) {
+    HashImpl::Algorithm algorithm;
+    std::string str_config;
+    try {
+        algorithm = HashImpl::fromConfig(config);
+        str_config = translateSHAConfig(config);
+    } catch (...) {
+        return 1;
+    }
+    // Consecutive items often share a key (e.g. the messages of one thread), the keyed state is reused then
+    std::unique_ptr<HmacImpl> keyed;
+    unsigned int keyedIndex = 0;
+    return runBatch(
+        CryptoDispatch::Op::HMAC, count, datalens, false,
+        [&](unsigned int i) {
+            if (!keyed || !sameKey(keys[keyedIndex], keylens[keyedIndex], keys[i], keylens[i])) {
+                keyed.reset(new HmacImpl(algorithm, keys[i], keylens[i]));
+                keyedIndex = i;
+            }
+            HmacImpl hmac(*keyed);
+            hmac.update(data[i], datalens[i]);
+            return hmac.digest();
+        },
+        "hmac",
+        [=](unsigned int i, val& params) {
+            params.set("engine", str_config);
+            params.set("data", createUint8Array(data[i], datalens[i]));
+            params.set("key", createUint8Array(keys[i], keylens[i]));
+        },
+        outs, outlens);
+}
+
+int privmxDrvCrypto_aesDecryptBatch(const char* const* keys, const char* const* ivs, const char* const* data,
+                                    const unsigned int* datalens, unsigned int count, const char* config,
+                                    char** outs, unsigned int* outlens) {
+    AesImpl::Mode mode;
+    std::string str_config;
+    try {
+        mode = AesImpl::fromConfig(config);
+        str_config = translateAESConfig(config);
+    } catch (...) {
+        return 1;
+    }
+    bool preferNative = mode != AesImpl::Mode::CBC_PKCS7;
+    std::unique_ptr<AesImpl> aes;
+    unsigned int aesIndex = 0;
+    return runBatch(
+        CryptoDispatch::Op::AES, count, datalens, preferNative,
+        [&](unsigned int i) {
+            if (!aes || !sameKey(keys[aesIndex], AesImpl::KEY_SIZE, keys[i], AesImpl::KEY_SIZE)) {
+                aes.reset(new AesImpl(keys[i]));
+                aesIndex = i;
+            }
+            return aes->decrypt(mode, ivs[i], data[i], datalens[i]);
+        },
+        str_config + "Decrypt",
+        [=](unsigned int i, val& params) {
+            params.set("data", createUint8Array(data[i], datalens[i]));
+            params.set("key", createUint8Array(keys[i], AesImpl::KEY_SIZE));
+            if (str_config != "aes256Ecb" && ivs[i] != nullptr) {
+                params.set("iv", createUint8Array(ivs[i], 16));
+            }
+        },
+        outs, outlens);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_setDispatch(const char* op, int mode, unsigned int threshold) {
+    if (mode < (int)CryptoDispatch::Mode::AUTO || mode > (int)CryptoDispatch::Mode::JS) {
+        return 1;
+    }
+    try {
+        CryptoDispatch::getInstance().configure(CryptoDispatch::opFromName(op), (CryptoDispatch::Mode)mode, threshold);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_getDispatchStats(const char* op, double* stats) {
+    try {
+        CryptoDispatch::Stats result = CryptoDispatch::getInstance().getStats(CryptoDispatch::opFromName(op));
+        stats[0] = result.nativeCalls;
+        stats[1] = result.nativeBytes;
+        stats[2] = result.jsCalls;
+        stats[3] = result.jsBytes;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_resetDispatchStats() {
+    CryptoDispatch::getInstance().resetStats();
+    return 0;
+}
+
+// Runs one of the EmCrypto key cache methods on the crypto thread; the result buffer is stored in out.
+int keyCacheCall(const char* method, const std::function<void(val&)>& setParams, std::string& out) {
+    auto future = AsyncEngine::getInstance()->callJsAsync([=](int callId) {
+        val params = val::object();
+        setParams(params);
+        performCryptoCall(method, params.as_handle(), callId);
+    }, CRYPTO_THREAD);
+
+    try {
+        char* res;
+        unsigned int reslen;
+        extractCryptoResult(future, &res, &reslen);
+        out.assign(res, reslen);
+        free(res);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_setKeyCacheCapacity(unsigned int capacity) {
+    std::string res;
+    return keyCacheCall("keyCacheConfigure", [capacity](val& params) { params.set("capacity", capacity); }, res);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_clearKeyCache() {
+    std::string res;
+    return keyCacheCall("keyCacheClear", [](val&) {}, res);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_getKeyCacheStats(double* stats, int reset) {
+    std::string res;
+    if (keyCacheCall("keyCacheStats", [reset](val& params) { params.set("reset", reset); }, res) != 0 ||
+        res.size() != 5 * sizeof(double)) {
+        return 1;
+    }
+    memcpy(stats, res.data(), res.size());
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_setKemCacheCapacity(unsigned int capacity) {
+    KemCache::getInstance().setCapacity(capacity);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_clearKemCache() {
+    KemCache::getInstance().clear();
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_getKemCacheStats(double* stats, int reset) {
+    KemCache::Stats result = KemCache::getInstance().getStats();
+    stats[0] = result.hits;
+    stats[1] = result.misses;
+    stats[2] = result.evictions;
+    stats[3] = result.size;
+    stats[4] = result.capacity;
+    if (reset) {
+        KemCache::getInstance().resetStats();
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvCrypto_getRandomStats(double* stats, int reset) {
+    RandomPool::Stats result = RandomPool::getStats();
+    stats[0] = result.pooledCalls;
+    stats[1] = result.directCalls;
+    stats[2] = result.refills;
+    stats[3] = result.fallbacks;
+    if (reset) {
+        RandomPool::resetStats();
+    }
+    return 0;
+}
+
 int privmxDrvCrypto_freeMem(void* ptr) {
     free(ptr);
     return 0;
@@ -0,0 +1,39 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_ECC_BENCH_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_ECC_BENCH_HPP_
+
+#include <emscripten.h>
+#include <stdio.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace bench {
+
+// Repeats fn for at least minMs and returns the mean time of a single call in microseconds.
+inline double measureUs(const std::function<void()>& fn, double minMs = 200) {
+    fn();  // warm-up
+    std::size_t iterations = 0;
+    double start = emscripten_get_now();
+    double elapsed = 0;
+    do {
+        fn();
+        ++iterations;
+        elapsed = emscripten_get_now() - start;
+    } while (elapsed < minMs);
+    return elapsed * 1000 / iterations;
+}
+
+}  // namespace bench
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_ECC_BENCH_HPP_
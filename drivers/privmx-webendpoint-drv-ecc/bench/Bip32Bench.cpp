@@ -0,0 +1,124 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// BIP32-style public derivation chains: every level computes K_child = K_parent + IL * G, i.e. one
+// PointImpl::mul (of the generator) and one PointImpl::add. IL is a fixed tweak per level instead of
+// HMAC-SHA512(chain code, K_parent || index), so only the point arithmetic is measured.
+
+#include <privmx/drv/Secp256k1Impl.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+
+// clang-format off
+
+// Mean time of one chain with elliptic.js in microseconds (-1 if node cannot require it); the last
+// child is written to out_hex so both paths can be compared.
+EM_JS(double, ellipticChainUs, (const char* parent_hex, int depth, char* out_hex), {
+    let elliptic;
+    try {
+        elliptic = require("elliptic");
+    } catch (e) {
+        return -1;
+    }
+    const ec = new elliptic.ec("secp256k1");
+    const BN = ec.n.constructor;
+    const tweaks = [];
+    for (let level = 0; level < depth; level++) {
+        const tweak = [];
+        for (let j = 0; j < 32; j++) tweak.push((level * 31 + j * 131 + 1) & 0xff);
+        tweak[0] &= 0x7f;
+        tweaks.push(new BN(tweak));
+    }
+    const parent = ec.curve.decodePoint(UTF8ToString(parent_hex), "hex");
+    const chain = () => {
+        let point = parent;
+        for (const tweak of tweaks) point = point.add(ec.g.mul(tweak));
+        return point;
+    };
+    let last = chain();
+    let iterations = 0;
+    const start = performance.now();
+    do {
+        last = chain();
+        ++iterations;
+    } while (performance.now() - start < 200);
+    const elapsed = performance.now() - start;
+    stringToUTF8(last.encodeCompressed("hex"), out_hex, 67);
+    return elapsed * 1000 / iterations;
+});
+
+// clang-format on
+
+namespace {
+
+std::string tweak(int level) {
+    std::string result(32, '\0');
+    for (int j = 0; j < 32; ++j) {
+        result[j] = static_cast<char>((level * 31 + j * 131 + 1) & 0xff);
+    }
+    result[0] = static_cast<char>(result[0] & 0x7f);
+    return result;
+}
+
+std::string toHex(const std::string& data) {
+    static const char* digits = "0123456789abcdef";
+    std::string result;
+    for (unsigned char c : data) {
+        result += digits[c >> 4];
+        result += digits[c & 0x0f];
+    }
+    return result;
+}
+
+}  // namespace
+
+int main() {
+    secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    const std::string generator(reinterpret_cast<const char*>(Secp256k1Impl::GENERATOR),
+                                sizeof(Secp256k1Impl::GENERATOR));
+    std::string privkey;
+    std::string parent;
+    if (!Secp256k1Impl::fromPrivateKey(ctx, std::string(32, '\x42'), privkey, parent)) {
+        throw std::runtime_error("Cannot create the parent key");
+    }
+
+    printf("\n%6s %16s %16s %16s %10s %6s\n", "depth", "native us", "native us/level", "elliptic us", "speedup",
+           "match");
+    for (int depth : {1, 5, 10, 20}) {
+        std::vector<std::string> tweaks;
+        for (int level = 0; level < depth; ++level) {
+            tweaks.push_back(tweak(level));
+        }
+        std::string child;
+        double nativeUs = bench::measureUs([&] {
+            child = parent;
+            std::string point;
+            for (const std::string& il : tweaks) {
+                if (!Secp256k1Impl::mul(ctx, generator, il, point) || !Secp256k1Impl::add(ctx, child, point, child)) {
+                    throw std::runtime_error("Derivation failed");
+                }
+            }
+        });
+        char ellipticChild[67] = {0};
+        double ellipticUs = ellipticChainUs(toHex(parent).c_str(), depth, ellipticChild);
+        if (ellipticUs < 0) {
+            printf("%6d %16.1f %16.1f %16s %10s %6s\n", depth, nativeUs, nativeUs / depth, "n/a", "n/a", "n/a");
+        } else {
+            printf("%6d %16.1f %16.1f %16.1f %10.1f %6s\n", depth, nativeUs, nativeUs / depth, ellipticUs,
+                   ellipticUs / nativeUs, toHex(child) == ellipticChild ? "yes" : "NO");
+        }
+    }
+    secp256k1_context_destroy(ctx);
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Verifying the author signatures of a listMessages page: one signature per item, from a handful of authors.
+// Compares a loop on the calling thread, as one privmxDrvEcc_eccVerify per item does, with VerifyPool, as
+// privmxDrvEcc_eccVerifyBatch does, each with and without PubkeyCache.
+
+#include <privmx/drv/PubkeyCache.hpp>
+#include <privmx/drv/SecpContext.hpp>
+#include <privmx/drv/VerifyPool.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "Bench.hpp"
+
+namespace {
+
+constexpr int AUTHORS = 8;
+
+std::vector<VerifyPool::Item> makePage(const secp256k1_context* ctx, std::size_t size) {
+    std::vector<VerifyPool::Item> items(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned char seckey[32];
+        for (int j = 0; j < 32; ++j) {
+            seckey[j] = static_cast<unsigned char>(i % AUTHORS * 17 + j + 1);
+            items[i].msg[j] = static_cast<unsigned char>(i * 131 + j * 7);
+        }
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_signature sig;
+        unsigned char serialized[33];
+        size_t len = sizeof(serialized);
+        if (!secp256k1_ec_pubkey_create(ctx, &pubkey, seckey) ||
+            !secp256k1_ec_pubkey_serialize(ctx, serialized, &len, &pubkey, SECP256K1_EC_COMPRESSED) ||
+            !secp256k1_ecdsa_sign(ctx, &sig, items[i].msg, seckey, nullptr, nullptr)) {
+            throw std::runtime_error("Cannot create the page");
+        }
+        secp256k1_ecdsa_signature_serialize_compact(ctx, items[i].sig, &sig);
+        items[i].pubkey.assign(reinterpret_cast<const char*>(serialized), len);
+    }
+    return items;
+}
+
+void check(const std::vector<int>& results) {
+    for (int result : results) {
+        if (result != 1) {
+            throw std::runtime_error("Verification failed");
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    secp256k1_context* ctx = SecpContext::get();
+    VerifyPool& pool = VerifyPool::getInstance();
+
+    printf("\n%6s %10s %14s %14s %10s %8s\n", "page", "key cache", "serial ms", "batch ms", "speedup", "threads");
+    for (std::size_t size : {100, 1000}) {
+        std::vector<VerifyPool::Item> items = makePage(ctx, size);
+        std::vector<int> results(size);
+        for (std::size_t capacity : {std::size_t(0), PubkeyCache::DEFAULT_CAPACITY}) {
+            PubkeyCache::getInstance().setCapacity(capacity);
+            double serialUs = bench::measureUs([&] {
+                for (std::size_t i = 0; i < size; ++i) {
+                    std::vector<VerifyPool::Item> one{items[i]};
+                    // Below MIN_PARALLEL_ITEMS, so on the calling thread
+                    pool.verify(ctx, one, &results[i]);
+                }
+            });
+            check(results);
+            double batchUs = bench::measureUs([&] { pool.verify(ctx, items, results.data()); });
+            check(results);
+            printf("%6zu %10s %14.3f %14.3f %10.2f %8zu\n", size, capacity ? "on" : "off", serialUs / 1000,
+                   batchUs / 1000, serialUs / batchUs, pool.getThreadsCount());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PUBKEYCACHE_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PUBKEYCACHE_HPP_
+
+#include <secp256k1.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Process-wide LRU cache of parsed public keys, so the author keys that repeat across a page of messages
+ * are parsed (a square root for a compressed key) and re-encoded once. Entries are looked up by the
+ * serialized key as given and hold the parsed secp256k1_pubkey with both of its encodings. Only keys
+ * libsecp256k1 accepts are cached; public keys are not secret, so entries are not wiped.
+ */
+class PubkeyCache {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        std::size_t size;
+        std::size_t capacity;
+    };
+
+    static PubkeyCache& getInstance();
+
+    // Both return false, like secp256k1_ec_pubkey_parse, if key cannot be parsed.
+    bool parse(const secp256k1_context* ctx, const std::string& key, secp256k1_pubkey& pubkey);
+    // key in compressed (33 bytes) or uncompressed (65 bytes) form.
+    bool encode(const secp256k1_context* ctx, const std::string& key, bool compressed, std::string& out);
+    // 0 disables the cache.
+    void setCapacity(std::size_t capacity);
+    void clear();
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Entry {
+        std::string key;
+        secp256k1_pubkey pubkey;
+        std::string compressed;
+        std::string uncompressed;
+    };
+    using EntryList = std::list<Entry>;
+
+    PubkeyCache() = default;
+
+    // Finds or parses key and calls fn(entry) with _mutex held; false if key cannot be parsed.
+    template<typename Fn>
+    bool lookup(const secp256k1_context* ctx, const std::string& key, Fn fn);
+    std::size_t shrink(std::size_t capacity);
+
+    mutable std::mutex _mutex;
+    // Most recently used first.
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _index;
+    std::size_t _capacity = DEFAULT_CAPACITY;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_PUBKEYCACHE_HPP_
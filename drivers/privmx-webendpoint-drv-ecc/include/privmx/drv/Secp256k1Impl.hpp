@@ -0,0 +1,64 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECP256K1IMPL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECP256K1IMPL_HPP_
+
+#include <secp256k1.h>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Native (libsecp256k1) versions of the elliptic.js operations behind ECCImpl, producing the same bytes:
+ * private keys and messages are reduced mod n, signatures are deterministic (RFC 6979) and keep elliptic's
+ * (possibly high) s and recovery param, derived secrets are the shared x coordinate mod n.
+ *
+ * Each method returns false when it cannot handle its input natively (e.g. a public key that
+ * libsecp256k1 rejects but elliptic accepts without validation); the caller then uses the JS driver.
+ */
+class Secp256k1Impl {
+public:
+    static constexpr std::size_t KEY_SIZE = 32;
+    static constexpr std::size_t SIGNATURE_SIZE = 65;
+    // Curve order n, big-endian.
+    static constexpr unsigned char ORDER[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41};
+    // Generator G, compressed.
+    static constexpr unsigned char GENERATOR[33] = {
+        0x02, 0x79, 0xBE, 0x66, 0x7E, 0xF9, 0xDC, 0xBB, 0xAC, 0x55, 0xA0, 0x62, 0x95, 0xCE, 0x87, 0x0B, 0x07,
+        0x02, 0x9B, 0xFC, 0xDB, 0x2D, 0xCE, 0x28, 0xD9, 0x59, 0xF2, 0x81, 0x5B, 0x16, 0xF8, 0x17, 0x98};
+
+    // Random private key and its compressed public key.
+    static bool genPair(const secp256k1_context* ctx, std::string& privkey, std::string& pubkey);
+    static bool fromPrivateKey(const secp256k1_context* ctx, const std::string& key, std::string& privkey,
+                               std::string& pubkey);
+    // Compressed encoding of key.
+    static bool fromPublicKey(const secp256k1_context* ctx, const std::string& key, std::string& pubkey);
+    // 27 + recovery param || r || s.
+    static bool sign(const secp256k1_context* ctx, const std::string& privkey, const std::string& data,
+                     std::string& signature);
+    // Throws if the first byte of signature is not a valid recovery param.
+    static bool verify(const secp256k1_context* ctx, const std::string& pubkey, const std::string& data,
+                       const std::string& signature, bool& result);
+    static bool verify(const secp256k1_context* ctx, const std::string& pubkey, const std::string& data,
+                       const std::string& r, const std::string& s, bool& result);
+    static bool derive(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+                       std::string& secret);
+    // point * scalar and point + point2, compressed. False for a result at infinity, as for unparsable points.
+    static bool mul(const secp256k1_context* ctx, const std::string& point, const std::string& scalar,
+                    std::string& result);
+    static bool add(const secp256k1_context* ctx, const std::string& point, const std::string& point2,
+                    std::string& result);
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECP256K1IMPL_HPP_
@@ -0,0 +1,44 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECPCONTEXT_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECPCONTEXT_HPP_
+
+#include <secp256k1.h>
+
+#include <cstdint>
+
+/**
+ * Per-thread secp256k1 contexts, so no context is shared between workers.
+ * A thread's context is created on its first ECC call (or by init()) and randomized with getentropy(), which
+ * blinds the generator multiplications of key generation and signing. It is randomized again every
+ * RERANDOMIZE_INTERVAL calls to get(). The precomputed tables are static in libsecp256k1, so creating a context
+ * builds none.
+ */
+class SecpContext {
+public:
+    static constexpr uint32_t RERANDOMIZE_INTERVAL = 1024;
+
+    struct Stats {
+        uint64_t contexts;
+        uint64_t randomizations;
+        // Randomizations skipped because no entropy was available; the context stays usable, unblinded.
+        uint64_t failedRandomizations;
+    };
+
+    // The calling thread's context; nullptr only if it could not be allocated.
+    static secp256k1_context* get();
+    // Creates the calling thread's context now, e.g. at worker start, so its first ECC call does not pay for it.
+    static bool init();
+    static Stats getStats();
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECPCONTEXT_HPP_
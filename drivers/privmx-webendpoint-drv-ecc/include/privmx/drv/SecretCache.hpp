@@ -0,0 +1,81 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECRETCACHE_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECRETCACHE_HPP_
+
+#include <secp256k1.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Process-wide LRU cache of ECCImpl::derive secrets, for the (own key, peer key) pairs that inbox entries
+ * and encrypted keys derive again and again. Entries are looked up by the ids of both keys: SHA-256
+ * fingerprints under a random per-process salt, never by the keys themselves. Secrets are zeroed when
+ * evicted or cleared; the endpoint clears the cache on disconnect.
+ */
+class SecretCache {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 128;
+    static constexpr std::size_t SECRET_SIZE = 32;
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        std::size_t size;
+        std::size_t capacity;
+    };
+
+    static SecretCache& getInstance();
+
+    // False on a miss; secret is left untouched then.
+    bool get(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+             std::string& secret);
+    // Secrets of any other size are not cached.
+    void put(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+             const std::string& secret);
+    // 0 disables the cache.
+    void setCapacity(std::size_t capacity);
+    void clear();
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Entry {
+        // Own key id || peer key id.
+        std::string id;
+        unsigned char secret[SECRET_SIZE];
+    };
+    using EntryList = std::list<Entry>;
+
+    SecretCache();
+
+    std::string id(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey) const;
+    std::size_t shrink(std::size_t capacity);
+
+    mutable std::mutex _mutex;
+    // Most recently used first.
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _index;
+    unsigned char _salt[32];
+    std::size_t _capacity = DEFAULT_CAPACITY;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_SECRETCACHE_HPP_
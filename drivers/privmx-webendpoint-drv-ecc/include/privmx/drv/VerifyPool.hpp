@@ -0,0 +1,72 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_CRYPTO_EMSCRIPTEN_VERIFYPOOL_HPP_
+#define _PRIVMXLIB_CRYPTO_EMSCRIPTEN_VERIFYPOOL_HPP_
+
+#include <secp256k1.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Verifies batches of ECDSA signatures (e.g. the author signatures of a listMessages page) on the calling
+ * thread and a few helper threads, each with its own secp256k1 context (SecpContext).
+ *
+ * The caller always takes part in its own batch, so a batch completes even while the helpers are busy with
+ * other batches or still starting. Helpers are started on first use and kept for the lifetime of the module.
+ */
+class VerifyPool {
+public:
+    // Threads working on one batch, the caller included.
+    static constexpr std::size_t MAX_THREADS = 4;
+    // Smaller batches are verified on the calling thread only.
+    static constexpr std::size_t MIN_PARALLEL_ITEMS = 16;
+
+    struct Item {
+        std::string pubkey;  // 33 or 65 bytes
+        unsigned char msg[32];
+        unsigned char sig[64];  // r || s
+    };
+
+    static VerifyPool& getInstance();
+
+    // results[i]: 1 if items[i] is valid, 0 if not, -1 if its key or signature cannot be parsed. Like
+    // privmxDrvEcc_eccVerify, s is normalized first, so both s and n - s are accepted.
+    void verify(const secp256k1_context* ctx, const std::vector<Item>& items, int* results);
+    std::size_t getThreadsCount() const { return _helpers.size() + 1; }
+
+    ~VerifyPool();
+    VerifyPool(const VerifyPool&) = delete;
+    VerifyPool& operator=(const VerifyPool&) = delete;
+
+private:
+    struct Batch;
+
+    explicit VerifyPool(std::size_t helpers);
+    void helperLoop();
+    static void run(const secp256k1_context* ctx, Batch& batch);
+    static int verifyItem(const secp256k1_context* ctx, const Item& item);
+
+    std::vector<std::thread> _helpers;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::shared_ptr<Batch>> _queue;
+    bool _stop = false;
+};
+
+#endif  // _PRIVMXLIB_CRYPTO_EMSCRIPTEN_VERIFYPOOL_HPP_
@@ -56,6 +56,11 @@ int privmxDrvEcc_eccGetPrivateKey(const privmxDrvEcc_ECC* ecc, privmxDrvEcc_BN**
 int privmxDrvEcc_eccSign(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, privmxDrvEcc_Signature* res);
 int privmxDrvEcc_eccVerify(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, const privmxDrvEcc_Signature* sig,
                            int* res);
+// Verifies count signatures in one call, spread over the calling thread and a few helper threads: item i checks
+// sigs[i] of the 32-byte msgs[i] with eccs[i]. results[i] is 1 if valid, 0 if not, -1 if the item cannot be checked
+// (bad key, signature or message length); the call returns non-zero if any item is -1.
+int privmxDrvEcc_eccVerifyBatch(privmxDrvEcc_ECC* const* eccs, const char* const* msgs, const int* msglens,
+                                const privmxDrvEcc_Signature* sigs, unsigned int count, int* results);
 int privmxDrvEcc_eccDerive(const privmxDrvEcc_ECC* ecc, const privmxDrvEcc_ECC* pub, char** res, int* reslen);
 int privmxDrvEcc_eccGetOrder(privmxDrvEcc_BN** res);
 int privmxDrvEcc_eccGetGenerator(privmxDrvEcc_Point** res);
@@ -63,6 +68,25 @@ int privmxDrvEcc_eccCopy(const privmxDrvEcc_ECC* src, privmxDrvEcc_ECC** dst);
 int privmxDrvEcc_eccNew(privmxDrvEcc_ECC** res);
 int privmxDrvEcc_eccFree(privmxDrvEcc_ECC* ecc);
 
+// Every thread uses its own randomized secp256k1 context, created on its first ECC call. initThread creates the
+// calling thread's context right away (e.g. at worker start). getContextStats fills stats (3 doubles) with contexts
+// created, randomizations and randomizations skipped for lack of entropy.
+int privmxDrvEcc_initThread(void);
+int privmxDrvEcc_getContextStats(double* stats);
+
+// Parsed public keys are cached (LRU, 256 keys by default, 0 disables it). getPubkeyCacheStats fills stats
+// (5 doubles) with hits, misses, evictions, size and capacity; the hit rate is hits / (hits + misses).
+int privmxDrvEcc_setPubkeyCacheCapacity(unsigned int capacity);
+int privmxDrvEcc_clearPubkeyCache(void);
+int privmxDrvEcc_getPubkeyCacheStats(double* stats, int reset);
+
+// Secrets derived by ECCImpl::derive are cached per (own key, peer key) pair (LRU, 128 pairs by default, 0 disables
+// it) and zeroed when evicted or cleared. clearSecretCache is called on disconnect. getSecretCacheStats fills stats
+// (5 doubles) with hits, misses, evictions, size and capacity.
+int privmxDrvEcc_setSecretCacheCapacity(unsigned int capacity);
+int privmxDrvEcc_clearSecretCache(void);
+int privmxDrvEcc_getSecretCacheStats(double* stats, int reset);
+
 int privmxDrvEcc_freeMem(void* ptr);
 
 #ifdef __cplusplus
@@ -9,45 +9,57 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include <Poco/JSON/Object.h>
-#include <emscripten/bind.h>
-#include <emscripten/emscripten.h>
-#include <emscripten/val.h>
+#include <gmp.h>
 
-#include <AsyncEngine.hpp>
-#include <Pson/BinaryString.hpp>
 #include <privmx/drv/BNImpl.hpp>
-#include <privmx/drv/Bindings.hpp>
 #include <stdexcept>
-
-#include "Mapper.hpp"
+#include <vector>
 
 using namespace std;
-using namespace emscripten;
-using namespace privmx::webendpoint;
 
 namespace {
 
-template<typename T>
-T runBnOp(const std::string& method, const Poco::Dynamic::Var& paramsVar) {
-    auto future = AsyncEngine::getInstance()->callJsAsync(
-        [&](int callId) {
-            Poco::Dynamic::Var localParams = paramsVar;
-            emscripten::val jsParams = Mapper::map((pson_value*)&localParams);
-            performBindingsCall(method, jsParams, callId);
-        },
-        ThreadTarget::Worker);
-
-    Poco::Dynamic::Var resultVar = future.get();
-    Poco::JSON::Object::Ptr obj = resultVar.extract<Poco::JSON::Object::Ptr>();
-    int status = obj->getValue<int>("status");
-
-    if (status < 0) {
-        std::string error = obj->getValue<std::string>("error");
-        throw std::runtime_error("Error: on " + method + ": " + error);
+void secureZero(void* ptr, size_t len) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(ptr);
+    while (len--) {
+        *p++ = 0;
+    }
+}
+
+// Big-endian bytes as limbs (least significant first), without high zero limbs.
+std::vector<mp_limb_t> toLimbs(const std::string& bytes) {
+    std::vector<mp_limb_t> limbs((bytes.size() + sizeof(mp_limb_t) - 1) / sizeof(mp_limb_t), 0);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        mp_limb_t byte = static_cast<unsigned char>(bytes[i]);
+        size_t bit = 8 * (bytes.size() - 1 - i);
+        limbs[bit / GMP_LIMB_BITS] |= byte << (bit % GMP_LIMB_BITS);
+    }
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    return limbs;
+}
+
+// Minimal big-endian bytes, "\0" for zero (bn.js toArray()).
+std::string fromLimbs(const mp_limb_t* limbs, size_t size) {
+    std::string bytes;
+    for (size_t i = size * sizeof(mp_limb_t); i-- > 0;) {
+        unsigned char byte = static_cast<unsigned char>(limbs[i / sizeof(mp_limb_t)] >> (8 * (i % sizeof(mp_limb_t))));
+        if (byte != 0 || !bytes.empty()) {
+            bytes.push_back(static_cast<char>(byte));
+        }
+    }
+    return bytes.empty() ? std::string(1, '\0') : bytes;
+}
+
+size_t significantOffset(const std::string& bytes) {
+    size_t offset = 0;
+    while (offset < bytes.size() && bytes[offset] == 0) {
+        ++offset;
     }
-    return obj->getValue<T>("buff");
+    return offset;
 }
+
 }  // namespace
 
 BNImpl::Ptr BNImpl::fromBuffer(const string& data) {
@@ -75,34 +87,52 @@ string BNImpl::toBuffer() const {
     return _bn;
 }
 
-// --- ASYNC IMPLEMENTATIONS ---
+// Operations on the unsigned big-endian value, with bn.js semantics (leading zero bytes do not count).
 
 std::size_t BNImpl::getBitsLength() const {
     validate();
-    Poco::JSON::Object::Ptr paramsObj = new Poco::JSON::Object();
-    paramsObj->set("bn", Pson::BinaryString(_bn));
-    return runBnOp<int>("bn_getBitsLength", paramsObj);
+    size_t offset = significantOffset(_bn);
+    if (offset == _bn.size()) {
+        return 0;
+    }
+    size_t bits = 8 * (_bn.size() - offset);
+    for (unsigned char top = static_cast<unsigned char>(_bn[offset]); !(top & 0x80); top <<= 1) {
+        --bits;
+    }
+    return bits;
 }
 
 BNImpl::Ptr BNImpl::umod(const BNImpl& bn) const {
     validate();
-
-    Poco::JSON::Object::Ptr paramsObj = new Poco::JSON::Object();
-    paramsObj->set("bn", Pson::BinaryString(_bn));
-    paramsObj->set("bn2", Pson::BinaryString(bn.toBuffer()));
-
-    std::string resultStr = runBnOp<Pson::BinaryString>("bn_umod", paramsObj);
-    return std::make_unique<BNImpl>(resultStr);
+    std::vector<mp_limb_t> mod = toLimbs(bn._bn);
+    if (mod.empty()) {
+        throw std::invalid_argument("Modulo by zero");
+    }
+    std::vector<mp_limb_t> value = toLimbs(_bn);
+    if (value.size() < mod.size()) {
+        return std::make_unique<BNImpl>(fromLimbs(value.data(), value.size()));
+    }
+    // Values are often private keys, so use GMP's side-channel silent remainder.
+    std::vector<mp_limb_t> scratch(mpn_sec_div_r_itch(value.size(), mod.size()));
+    mpn_sec_div_r(value.data(), value.size(), mod.data(), mod.size(), scratch.data());
+    auto result = std::make_unique<BNImpl>(fromLimbs(value.data(), mod.size()));
+    secureZero(value.data(), value.size() * sizeof(mp_limb_t));
+    secureZero(scratch.data(), scratch.size() * sizeof(mp_limb_t));
+    return result;
 }
 
 bool BNImpl::eq(const BNImpl& bn) const {
     validate();
-
-    Poco::JSON::Object::Ptr paramsObj = new Poco::JSON::Object();
-    paramsObj->set("bn", Pson::BinaryString(_bn));
-    paramsObj->set("bn2", Pson::BinaryString(bn.toBuffer()));
-
-    return runBnOp<bool>("bn_eq", paramsObj);
+    size_t offset = significantOffset(_bn);
+    size_t offset2 = significantOffset(bn._bn);
+    if (_bn.size() - offset != bn._bn.size() - offset2) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (size_t i = 0; offset + i < _bn.size(); ++i) {
+        diff |= _bn[offset + i] ^ bn._bn[offset2 + i];
+    }
+    return diff == 0;
 }
 
 void BNImpl::validate() const {
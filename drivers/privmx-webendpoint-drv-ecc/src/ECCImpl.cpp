@@ -20,6 +20,9 @@ limitations under the License.
 #include <privmx/drv/Bindings.hpp>
 #include <privmx/drv/ECCImpl.hpp>
 #include <privmx/drv/PointImpl.hpp>
+#include <privmx/drv/SecretCache.hpp>
+#include <privmx/drv/Secp256k1Impl.hpp>
+#include <privmx/drv/SecpContext.hpp>
 #include <stdexcept>
 
 #include "Mapper.hpp"
@@ -107,42 +110,70 @@ BNImpl::Ptr ECCImpl::getPrivateKey2() const {
     return std::make_unique<BNImpl>(_privkey);
 }
 
-// --- ASYNC IMPLEMENTATIONS ---
+// Key, signature and ECDH operations run natively on the calling worker (Secp256k1Impl) with its own context
+// (SecpContext). Inputs it does not handle, e.g. public keys that libsecp256k1 rejects but elliptic accepts, go to
+// elliptic on the crypto thread.
 
 ECCImpl::Ptr ECCImpl::genPair() {
+    std::string priv_key;
+    std::string pub_key;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::genPair(ctx, priv_key, pub_key)) {
+        return std::make_unique<ECCImpl>(priv_key, pub_key, true);
+    }
+
     Poco::Dynamic::Var params;  // Null/Empty
 
     Poco::JSON::Object::Ptr result = runEccOpObj("ecc_genPair", params);
 
-    std::string priv_key = result->getValue<Pson::BinaryString>("privateKey");
-    std::string pub_key = result->getValue<Pson::BinaryString>("publicKey");
+    priv_key = result->getValue<Pson::BinaryString>("privateKey");
+    pub_key = result->getValue<Pson::BinaryString>("publicKey");
 
     return std::make_unique<ECCImpl>(priv_key, pub_key, true);
 }
 
 ECCImpl::Ptr ECCImpl::fromPublicKey(const string& public_key) {
+    std::string pub_key;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::fromPublicKey(ctx, public_key, pub_key)) {
+        return std::make_unique<ECCImpl>(std::string(), pub_key, false);
+    }
+
     Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
     params->set("key", Pson::BinaryString(public_key));
 
     Poco::JSON::Object::Ptr result = runEccOpObj("ecc_fromPublicKey", params);
-    std::string pub_key = result->getValue<Pson::BinaryString>("publicKey");
+    pub_key = result->getValue<Pson::BinaryString>("publicKey");
 
     return std::make_unique<ECCImpl>(std::string(), pub_key, false);
 }
 
 ECCImpl::Ptr ECCImpl::fromPrivateKey(const std::string& private_key) {
+    std::string priv_key;
+    std::string pub_key;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::fromPrivateKey(ctx, private_key, priv_key, pub_key)) {
+        return std::make_unique<ECCImpl>(priv_key, pub_key, true);
+    }
+
     Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
     params->set("key", Pson::BinaryString(private_key));
 
     Poco::JSON::Object::Ptr result = runEccOpObj("ecc_fromPrivateKey", params);
 
-    std::string priv_key = result->getValue<Pson::BinaryString>("privateKey");
-    std::string pub_key = result->getValue<Pson::BinaryString>("publicKey");
+    priv_key = result->getValue<Pson::BinaryString>("privateKey");
+    pub_key = result->getValue<Pson::BinaryString>("publicKey");
 
     return std::make_unique<ECCImpl>(priv_key, pub_key, true);
 }
 
 string ECCImpl::sign(const string& data) const {
+    std::string signature;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::sign(ctx, _privkey, data, signature)) {
+        return signature;
+    }
+
     Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
     params->set("privateKey", Pson::BinaryString(_privkey));
     params->set("data", Pson::BinaryString(data));
@@ -159,6 +190,12 @@ Signature ECCImpl::sign2(const string& data) const {
 }
 
 bool ECCImpl::verify(const std::string& data, const std::string& signature) const {
+    bool result;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::verify(ctx, _pubkey, data, signature, result)) {
+        return result;
+    }
+
     Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
     params->set("publicKey", Pson::BinaryString(_pubkey));
     params->set("data", Pson::BinaryString(data));
@@ -168,45 +205,59 @@ bool ECCImpl::verify(const std::string& data, const std::string& signature) cons
 }
 
 bool ECCImpl::verify2(const std::string& data, const Signature& signature) const {
+    std::string r = signature.r->toBuffer();
+    std::string s = signature.s->toBuffer();
+    bool result;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::verify(ctx, _pubkey, data, r, s, result)) {
+        return result;
+    }
+
     Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
+    params->set("publicKey", Pson::BinaryString(_pubkey));
     params->set("data", Pson::BinaryString(data));
 
-    params->set("r", Pson::BinaryString(signature.r->toBuffer()));
-    params->set("s", Pson::BinaryString(signature.s->toBuffer()));
+    params->set("r", Pson::BinaryString(r));
+    params->set("s", Pson::BinaryString(s));
     return runEccOp<bool>("ecc_verify2", params);
 }
 
 string ECCImpl::derive(const ECCImpl& ecc) const {
-    Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
-    params->set("privateKey", Pson::BinaryString(_privkey));
-    params->set("publicKey", Pson::BinaryString(ecc._pubkey));
+    std::string secret;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && SecretCache::getInstance().get(ctx, _privkey, ecc._pubkey, secret)) {
+        return secret;
+    }
+    if (!ctx || !Secp256k1Impl::derive(ctx, _privkey, ecc._pubkey, secret)) {
+        Poco::JSON::Object::Ptr params = new Poco::JSON::Object();
+        params->set("privateKey", Pson::BinaryString(_privkey));
+        params->set("publicKey", Pson::BinaryString(ecc._pubkey));
 
-    return runEccOp<Pson::BinaryString>("ecc_derive", params);
+        secret = runEccOp<Pson::BinaryString>("ecc_derive", params);
+    }
+    if (ctx) {
+        SecretCache::getInstance().put(ctx, _privkey, ecc._pubkey, secret);
+    }
+    return secret;
 }
 
 std::string ECCImpl::getOrder() {
-    Poco::Dynamic::Var params;  // Null
-    return runEccOp<Pson::BinaryString>("ecc_getOrder", params);
+    return std::string(reinterpret_cast<const char*>(Secp256k1Impl::ORDER), sizeof(Secp256k1Impl::ORDER));
 }
 
 BNImpl::Ptr ECCImpl::getOrder2() {
-    std::string n = getOrder();  // OK: static calling static
-    return std::make_unique<BNImpl>(n);
+    return std::make_unique<BNImpl>(getOrder());
 }
 
 PointImpl::Ptr ECCImpl::getGenerator() const {
-    Poco::Dynamic::Var params;  // Null
-    std::string g = runEccOp<Pson::BinaryString>("ecc_getGenerator", params);
-    return std::make_unique<PointImpl>(g);
+    return getEcGenerator();
 }
 
 BNImpl::Ptr ECCImpl::getEcOrder() const {
-    return std::make_unique<BNImpl>(getOrder());
+    return getOrder2();
 }
 
 PointImpl::Ptr ECCImpl::getEcGenerator() {
-    // Same as getGenerator
-    Poco::Dynamic::Var params;
-    std::string g = runEccOp<Pson::BinaryString>("ecc_getGenerator", params);
-    return std::make_unique<PointImpl>(g);
-}
\ No newline at end of file
+    return std::make_unique<PointImpl>(
+        std::string(reinterpret_cast<const char*>(Secp256k1Impl::GENERATOR), sizeof(Secp256k1Impl::GENERATOR)));
+}
@@ -21,9 +21,11 @@ limitations under the License.
 #include <privmx/drv/Bindings.hpp>
 #include <privmx/drv/ECCImpl.hpp>
 #include <privmx/drv/PointImpl.hpp>
+#include <privmx/drv/PubkeyCache.hpp>
+#include <privmx/drv/Secp256k1Impl.hpp>
+#include <privmx/drv/SecpContext.hpp>
 #include <stdexcept>
 #include <string>
-#include <vector>
 
 #include "Mapper.hpp"
 
@@ -66,30 +68,27 @@ string PointImpl::encode(secp256k1_context* ctx, bool compact) const {
     }
     if (ctx == nullptr) throw std::runtime_error("Error: Failed to get secp256k1 context");
 
-    secp256k1_pubkey pubkey;
-    if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, reinterpret_cast<const unsigned char*>(_point.data()),
-                                   _point.size())) {
+    std::string encoded;
+    if (!PubkeyCache::getInstance().encode(ctx, _point, compact, encoded)) {
         throw std::runtime_error("Error: Failed to parse point data");
     }
-    unsigned int flags = compact ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
-    size_t output_size = compact ? 33 : 65;
-    std::vector<unsigned char> output_buffer(output_size);
-    size_t output_len = output_size;
-    if (!secp256k1_ec_pubkey_serialize(ctx, output_buffer.data(), &output_len, &pubkey, flags)) {
-        throw std::runtime_error("Error: Failed to serialize point");
-    }
-    if (output_len != output_size) throw std::runtime_error("Error: Serialized point has unexpected length");
-
-    return std::string(output_buffer.begin(), output_buffer.end());
+    return encoded;
 }
 
 // ----------------------------------------------------------------------------
-//  ASYNC OPERATIONS
+//  ARITHMETIC: native (secp256k1 tweak / combine), elliptic on the crypto thread for the points and results
+//  libsecp256k1 cannot represent (unvalidated points, infinity)
 // ----------------------------------------------------------------------------
 
 PointImpl::Ptr PointImpl::mul(const BNImpl& bn) const {
     validate();
 
+    std::string result;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::mul(ctx, _point, bn.toBuffer(), result)) {
+        return std::make_unique<PointImpl>(result);
+    }
+
     std::string pointStr = _point;
     std::string bnStr = bn.toBuffer();
 
@@ -118,6 +117,12 @@ PointImpl::Ptr PointImpl::mul(const BNImpl& bn) const {
 PointImpl::Ptr PointImpl::add(const PointImpl& point) const {
     validate();
 
+    std::string result;
+    secp256k1_context* ctx = SecpContext::get();
+    if (ctx && Secp256k1Impl::add(ctx, _point, point._point, result)) {
+        return std::make_unique<PointImpl>(result);
+    }
+
     std::string point1Str = _point;
     std::string point2Str = point._point;
 
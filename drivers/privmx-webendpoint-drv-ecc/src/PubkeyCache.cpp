@@ -0,0 +1,102 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <privmx/drv/PubkeyCache.hpp>
+
+namespace {
+
+std::string serialize(const secp256k1_context* ctx, const secp256k1_pubkey& pubkey, unsigned int flags) {
+    unsigned char out[65];
+    size_t outlen = sizeof(out);
+    secp256k1_ec_pubkey_serialize(ctx, out, &outlen, &pubkey, flags);
+    return std::string(reinterpret_cast<const char*>(out), outlen);
+}
+
+}  // namespace
+
+PubkeyCache& PubkeyCache::getInstance() {
+    static PubkeyCache instance;
+    return instance;
+}
+
+template<typename Fn>
+bool PubkeyCache::lookup(const secp256k1_context* ctx, const std::string& key, Fn fn) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto found = _index.find(key);
+    if (found != _index.end()) {
+        ++_hits;
+        _entries.splice(_entries.begin(), _entries, found->second);
+        fn(*found->second);
+        return true;
+    }
+    ++_misses;
+    lock.unlock();
+    Entry entry;
+    if (!secp256k1_ec_pubkey_parse(ctx, &entry.pubkey, reinterpret_cast<const unsigned char*>(key.data()),
+                                   key.size())) {
+        return false;
+    }
+    entry.key = key;
+    entry.compressed = serialize(ctx, entry.pubkey, SECP256K1_EC_COMPRESSED);
+    entry.uncompressed = serialize(ctx, entry.pubkey, SECP256K1_EC_UNCOMPRESSED);
+    lock.lock();
+    // Another thread may have parsed the same key meanwhile, or the cache may have been disabled
+    if (_capacity == 0 || _index.count(key) > 0) {
+        fn(entry);
+        return true;
+    }
+    _entries.push_front(std::move(entry));
+    _index[key] = _entries.begin();
+    _evictions += shrink(_capacity);
+    fn(_entries.front());
+    return true;
+}
+
+bool PubkeyCache::parse(const secp256k1_context* ctx, const std::string& key, secp256k1_pubkey& pubkey) {
+    return lookup(ctx, key, [&](const Entry& entry) { pubkey = entry.pubkey; });
+}
+
+bool PubkeyCache::encode(const secp256k1_context* ctx, const std::string& key, bool compressed, std::string& out) {
+    return lookup(ctx, key, [&](const Entry& entry) { out = compressed ? entry.compressed : entry.uncompressed; });
+}
+
+void PubkeyCache::setCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    _evictions += shrink(_capacity);
+}
+
+void PubkeyCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    shrink(0);
+}
+
+PubkeyCache::Stats PubkeyCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Stats{_hits, _misses, _evictions, _entries.size(), _capacity};
+}
+
+void PubkeyCache::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+// Drops least recently used entries down to capacity and returns their number; _mutex must be held.
+std::size_t PubkeyCache::shrink(std::size_t capacity) {
+    std::size_t dropped = 0;
+    for (; _entries.size() > capacity; ++dropped) {
+        _index.erase(_entries.back().key);
+        _entries.pop_back();
+    }
+    return dropped;
+}
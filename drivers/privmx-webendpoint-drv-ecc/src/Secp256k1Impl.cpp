@@ -0,0 +1,301 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <secp256k1_ecdh.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <privmx/drv/PubkeyCache.hpp>
+#include <privmx/drv/Secp256k1Impl.hpp>
+#include <stdexcept>
+
+namespace {
+
+void secureZero(void* ptr, size_t len) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(ptr);
+    while (len--) {
+        *p++ = 0;
+    }
+}
+
+bool equalConstTime(const unsigned char* a, const unsigned char* b, size_t len) {
+    unsigned char diff = 0;
+    for (size_t i = 0; i < len; ++i) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+// a -= n if a >= n, without branching on a. Enough to reduce any 32-byte value, as 2^256 < 2n.
+void reduceOnce(unsigned char* a) {
+    unsigned char diff[32];
+    int borrow = 0;
+    for (int i = 31; i >= 0; --i) {
+        int d = a[i] - Secp256k1Impl::ORDER[i] - borrow;
+        borrow = d < 0;
+        diff[i] = static_cast<unsigned char>(d);
+    }
+    unsigned char mask = static_cast<unsigned char>(borrow - 1);
+    for (int i = 0; i < 32; ++i) {
+        a[i] = (diff[i] & mask) | (a[i] & ~mask);
+    }
+    secureZero(diff, sizeof(diff));
+}
+
+size_t significantOffset(const std::string& in) {
+    size_t offset = 0;
+    while (offset < in.size() && in[offset] == 0) {
+        ++offset;
+    }
+    return offset;
+}
+
+// Big-endian integer of any length as 32 bytes; false if it does not fit.
+bool toBytes32(const std::string& in, unsigned char* out) {
+    size_t offset = significantOffset(in);
+    size_t len = in.size() - offset;
+    if (len > 32) {
+        return false;
+    }
+    memset(out, 0, 32 - len);
+    memcpy(out + 32 - len, in.data() + offset, len);
+    return true;
+}
+
+// Like elliptic's keyFromPrivate: the key mod n, which must not be zero.
+bool toPrivateKey(const secp256k1_context* ctx, const std::string& in, unsigned char* out) {
+    if (!toBytes32(in, out)) {
+        return false;
+    }
+    reduceOnce(out);
+    if (!secp256k1_ec_seckey_verify(ctx, out)) {
+        secureZero(out, 32);
+        return false;
+    }
+    return true;
+}
+
+// Like elliptic's _truncateToN: the leftmost 256 bits of the message (leading zero bytes do not count) mod n.
+void toMessage(const std::string& in, unsigned char* out) {
+    size_t offset = significantOffset(in);
+    size_t len = std::min<size_t>(in.size() - offset, 32);
+    memset(out, 0, 32 - len);
+    memcpy(out + 32 - len, in.data() + offset, len);
+    reduceOnce(out);
+}
+
+std::string serialize(const secp256k1_context* ctx, const secp256k1_pubkey& pubkey) {
+    unsigned char out[33];
+    size_t outlen = sizeof(out);
+    secp256k1_ec_pubkey_serialize(ctx, out, &outlen, &pubkey, SECP256K1_EC_COMPRESSED);
+    return std::string(reinterpret_cast<const char*>(out), outlen);
+}
+
+// Points of mul() and add() are mostly one-off (e.g. BIP32 children), so unlike keys they bypass PubkeyCache.
+bool parsePublicKey(const secp256k1_context* ctx, const std::string& in, secp256k1_pubkey& pubkey) {
+    return secp256k1_ec_pubkey_parse(ctx, &pubkey, reinterpret_cast<const unsigned char*>(in.data()), in.size());
+}
+
+// RFC 6979 nonce (the HMAC-DRBG elliptic uses), kept so sign() can recover R = k * G.
+int captureNonce(unsigned char* nonce32, const unsigned char* msg32, const unsigned char* key32,
+                 const unsigned char* algo16, void* data, unsigned int attempt) {
+    int ret = secp256k1_nonce_function_rfc6979(nonce32, msg32, key32, algo16, nullptr, attempt);
+    if (ret) {
+        memcpy(data, nonce32, 32);
+    }
+    return ret;
+}
+
+int copyX(unsigned char* output, const unsigned char* x32, const unsigned char* y32, void* data) {
+    (void)y32;
+    (void)data;
+    memcpy(output, x32, 32);
+    return 1;
+}
+
+}  // namespace
+
+bool Secp256k1Impl::genPair(const secp256k1_context* ctx, std::string& privkey, std::string& pubkey) {
+    unsigned char key[KEY_SIZE];
+    do {
+        if (getentropy(key, sizeof(key)) != 0) {
+            return false;
+        }
+    } while (!secp256k1_ec_seckey_verify(ctx, key));
+    secp256k1_pubkey point;
+    bool ok = secp256k1_ec_pubkey_create(ctx, &point, key);
+    if (ok) {
+        privkey.assign(reinterpret_cast<const char*>(key), sizeof(key));
+        pubkey = serialize(ctx, point);
+    }
+    secureZero(key, sizeof(key));
+    return ok;
+}
+
+bool Secp256k1Impl::fromPrivateKey(const secp256k1_context* ctx, const std::string& key, std::string& privkey,
+                                   std::string& pubkey) {
+    unsigned char seckey[KEY_SIZE];
+    if (!toPrivateKey(ctx, key, seckey)) {
+        return false;
+    }
+    secp256k1_pubkey point;
+    bool ok = secp256k1_ec_pubkey_create(ctx, &point, seckey);
+    if (ok) {
+        privkey.assign(reinterpret_cast<const char*>(seckey), sizeof(seckey));
+        pubkey = serialize(ctx, point);
+    }
+    secureZero(seckey, sizeof(seckey));
+    return ok;
+}
+
+bool Secp256k1Impl::fromPublicKey(const secp256k1_context* ctx, const std::string& key, std::string& pubkey) {
+    return PubkeyCache::getInstance().encode(ctx, key, true, pubkey);
+}
+
+bool Secp256k1Impl::sign(const secp256k1_context* ctx, const std::string& privkey, const std::string& data,
+                         std::string& signature) {
+    unsigned char seckey[KEY_SIZE];
+    if (!toPrivateKey(ctx, privkey, seckey)) {
+        return false;
+    }
+    unsigned char msg[32];
+    unsigned char nonce[32];
+    unsigned char lhs[32];
+    unsigned char rhs[32];
+    unsigned char compact[64];
+    unsigned char rpoint[33];
+    size_t rpointlen = sizeof(rpoint);
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey point;
+    toMessage(data, msg);
+
+    // libsecp256k1 always returns the low s. elliptic keeps s = k^-1 * (m + r * d), so negate s back unless
+    // s * k == m + r * d. The recovery param comes from R = k * G, as in elliptic.
+    bool ok = secp256k1_ecdsa_sign(ctx, &sig, msg, seckey, captureNonce, nonce) &&
+              secp256k1_ecdsa_signature_serialize_compact(ctx, compact, &sig) &&
+              secp256k1_ec_pubkey_create(ctx, &point, nonce) &&
+              secp256k1_ec_pubkey_serialize(ctx, rpoint, &rpointlen, &point, SECP256K1_EC_COMPRESSED);
+    if (ok) {
+        memcpy(lhs, nonce, 32);
+        memcpy(rhs, seckey, 32);
+        ok = secp256k1_ec_seckey_tweak_mul(ctx, lhs, compact + 32) &&
+             secp256k1_ec_seckey_tweak_mul(ctx, rhs, compact) && secp256k1_ec_seckey_tweak_add(ctx, rhs, msg);
+    }
+    if (ok && !equalConstTime(lhs, rhs, 32)) {
+        ok = secp256k1_ec_seckey_negate(ctx, compact + 32);
+    }
+    if (ok) {
+        int recoveryParam = (rpoint[0] == 0x03 ? 1 : 0) | (memcmp(rpoint + 1, compact, 32) != 0 ? 2 : 0);
+        signature.resize(SIGNATURE_SIZE);
+        signature[0] = static_cast<char>(27 + recoveryParam);
+        memcpy(&signature[1], compact, 64);
+    }
+    secureZero(seckey, sizeof(seckey));
+    secureZero(nonce, sizeof(nonce));
+    secureZero(lhs, sizeof(lhs));
+    secureZero(rhs, sizeof(rhs));
+    return ok;
+}
+
+bool Secp256k1Impl::verify(const secp256k1_context* ctx, const std::string& pubkey, const std::string& data,
+                           const std::string& signature, bool& result) {
+    if (signature.empty()) {
+        throw std::invalid_argument("Invalid signature");
+    }
+    // 27-30 as produced by sign(), the other ranges are recovery params with address type flags
+    unsigned char header = static_cast<unsigned char>(signature[0]);
+    if (header < 27 || header > 42) {
+        throw std::invalid_argument("Invalid recovery param value");
+    }
+    std::string r = signature.substr(1, 32);
+    std::string s = signature.size() > 33 ? signature.substr(33) : std::string();
+    return verify(ctx, pubkey, data, r, s, result);
+}
+
+bool Secp256k1Impl::verify(const secp256k1_context* ctx, const std::string& pubkey, const std::string& data,
+                           const std::string& r, const std::string& s, bool& result) {
+    secp256k1_pubkey point;
+    if (!PubkeyCache::getInstance().parse(ctx, pubkey, point)) {
+        return false;
+    }
+    unsigned char compact[64];
+    secp256k1_ecdsa_signature sig;
+    // r or s >= n (including anything longer than 32 bytes) never verifies
+    if (!toBytes32(r, compact) || !toBytes32(s, compact + 32) ||
+        !secp256k1_ecdsa_signature_parse_compact(ctx, &sig, compact)) {
+        result = false;
+        return true;
+    }
+    // elliptic accepts high s, libsecp256k1 only verifies the low one
+    secp256k1_ecdsa_signature_normalize(ctx, &sig, &sig);
+    unsigned char msg[32];
+    toMessage(data, msg);
+    result = secp256k1_ecdsa_verify(ctx, &sig, msg, &point) == 1;
+    return true;
+}
+
+bool Secp256k1Impl::derive(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+                           std::string& secret) {
+    secp256k1_pubkey point;
+    if (!PubkeyCache::getInstance().parse(ctx, pubkey, point)) {
+        return false;
+    }
+    unsigned char seckey[KEY_SIZE];
+    if (!toPrivateKey(ctx, privkey, seckey)) {
+        return false;
+    }
+    unsigned char x[32];
+    bool ok = secp256k1_ecdh(ctx, x, &point, seckey, copyX, nullptr);
+    if (ok) {
+        // elliptic re-imports the x coordinate as a private key, i.e. mod n
+        reduceOnce(x);
+        secret.assign(reinterpret_cast<const char*>(x), sizeof(x));
+    }
+    secureZero(seckey, sizeof(seckey));
+    secureZero(x, sizeof(x));
+    return ok;
+}
+
+bool Secp256k1Impl::mul(const secp256k1_context* ctx, const std::string& point, const std::string& scalar,
+                        std::string& result) {
+    // k * G (BIP32 public derivation) uses the precomputed generator tables instead of a generic multiplication
+    bool isGenerator = point.size() == sizeof(GENERATOR) && memcmp(point.data(), GENERATOR, sizeof(GENERATOR)) == 0;
+    secp256k1_pubkey pubkey;
+    unsigned char tweak[32];
+    if ((!isGenerator && !parsePublicKey(ctx, point, pubkey)) || !toBytes32(scalar, tweak)) {
+        return false;
+    }
+    // elliptic multiplies by any scalar, k * P == (k mod n) * P; zero (mod n) gives infinity
+    reduceOnce(tweak);
+    bool ok = isGenerator ? secp256k1_ec_pubkey_create(ctx, &pubkey, tweak)
+                          : secp256k1_ec_pubkey_tweak_mul(ctx, &pubkey, tweak);
+    if (ok) {
+        result = serialize(ctx, pubkey);
+    }
+    secureZero(tweak, sizeof(tweak));
+    return ok;
+}
+
+bool Secp256k1Impl::add(const secp256k1_context* ctx, const std::string& point, const std::string& point2,
+                        std::string& result) {
+    secp256k1_pubkey pubkeys[2];
+    if (!parsePublicKey(ctx, point, pubkeys[0]) || !parsePublicKey(ctx, point2, pubkeys[1])) {
+        return false;
+    }
+    const secp256k1_pubkey* ins[2] = {&pubkeys[0], &pubkeys[1]};
+    secp256k1_pubkey sum;
+    if (!secp256k1_ec_pubkey_combine(ctx, &sum, ins, 2)) {
+        return false;
+    }
+    result = serialize(ctx, sum);
+    return true;
+}
@@ -0,0 +1,74 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <unistd.h>
+
+#include <atomic>
+#include <privmx/drv/SecpContext.hpp>
+
+namespace {
+
+std::atomic<uint64_t> contexts{0};
+std::atomic<uint64_t> randomizations{0};
+std::atomic<uint64_t> failedRandomizations{0};
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+void randomize(secp256k1_context* ctx) {
+    unsigned char seed[32];
+    if (getentropy(seed, sizeof(seed)) == 0 && secp256k1_context_randomize(ctx, seed)) {
+        randomizations.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        failedRandomizations.fetch_add(1, std::memory_order_relaxed);
+    }
+    secureZero(seed, sizeof(seed));
+}
+
+struct ThreadContext {
+    ~ThreadContext() {
+        if (ctx) {
+            secp256k1_context_destroy(ctx);
+        }
+    }
+
+    secp256k1_context* ctx = nullptr;
+    uint32_t uses = 0;
+};
+
+thread_local ThreadContext current;
+
+}  // namespace
+
+secp256k1_context* SecpContext::get() {
+    if (!current.ctx) {
+        current.ctx = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+        if (!current.ctx) {
+            return nullptr;
+        }
+        contexts.fetch_add(1, std::memory_order_relaxed);
+        randomize(current.ctx);
+    } else if (++current.uses == RERANDOMIZE_INTERVAL) {
+        current.uses = 0;
+        randomize(current.ctx);
+    }
+    return current.ctx;
+}
+
+bool SecpContext::init() {
+    return get() != nullptr;
+}
+
+SecpContext::Stats SecpContext::getStats() {
+    return Stats{contexts.load(), randomizations.load(), failedRandomizations.load()};
+}
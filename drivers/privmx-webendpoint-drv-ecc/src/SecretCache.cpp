@@ -0,0 +1,135 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string.h>
+#include <unistd.h>
+
+#include <privmx/drv/SecretCache.hpp>
+
+namespace {
+
+void secureZero(void* ptr, std::size_t len) {
+    volatile unsigned char* p = reinterpret_cast<volatile unsigned char*>(ptr);
+    while (len--) *p++ = 0;
+}
+
+// SHA-256 of domain || key, tagged with the salt, so ids of private and public keys never collide.
+void fingerprint(const secp256k1_context* ctx, const unsigned char* salt, std::size_t saltlen, char domain,
+                 const std::string& key, unsigned char* out) {
+    std::string msg;
+    msg.reserve(key.size() + 1);
+    msg += domain;
+    msg += key;
+    secp256k1_tagged_sha256(ctx, out, salt, saltlen, reinterpret_cast<const unsigned char*>(msg.data()),
+                            msg.size());
+    secureZero(&msg[0], msg.size());
+}
+
+}  // namespace
+
+SecretCache& SecretCache::getInstance() {
+    static SecretCache instance;
+    return instance;
+}
+
+SecretCache::SecretCache() {
+    // Without a random salt ids could be precomputed, so the cache stays disabled
+    if (getentropy(_salt, sizeof(_salt)) != 0) {
+        _capacity = 0;
+    }
+}
+
+bool SecretCache::get(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+                      std::string& secret) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_capacity == 0) {
+        ++_misses;
+        return false;
+    }
+    lock.unlock();
+    std::string key = id(ctx, privkey, pubkey);
+    lock.lock();
+    auto found = _index.find(key);
+    if (found == _index.end()) {
+        ++_misses;
+        return false;
+    }
+    ++_hits;
+    _entries.splice(_entries.begin(), _entries, found->second);
+    secret.assign(reinterpret_cast<const char*>(found->second->secret), SECRET_SIZE);
+    return true;
+}
+
+void SecretCache::put(const secp256k1_context* ctx, const std::string& privkey, const std::string& pubkey,
+                      const std::string& secret) {
+    if (secret.size() != SECRET_SIZE) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_capacity == 0) {
+        return;
+    }
+    lock.unlock();
+    std::string key = id(ctx, privkey, pubkey);
+    lock.lock();
+    // Another thread may have derived the same pair meanwhile, or the cache may have been disabled
+    if (_capacity == 0 || _index.count(key) > 0) {
+        return;
+    }
+    _entries.emplace_front();
+    _entries.front().id = key;
+    memcpy(_entries.front().secret, secret.data(), SECRET_SIZE);
+    _index[key] = _entries.begin();
+    _evictions += shrink(_capacity);
+}
+
+void SecretCache::setCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    _evictions += shrink(_capacity);
+}
+
+void SecretCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    shrink(0);
+}
+
+SecretCache::Stats SecretCache::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Stats{_hits, _misses, _evictions, _entries.size(), _capacity};
+}
+
+void SecretCache::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+std::string SecretCache::id(const secp256k1_context* ctx, const std::string& privkey,
+                            const std::string& pubkey) const {
+    unsigned char out[64];
+    fingerprint(ctx, _salt, sizeof(_salt), 0, privkey, out);
+    fingerprint(ctx, _salt, sizeof(_salt), 1, pubkey, out + 32);
+    return std::string(reinterpret_cast<const char*>(out), sizeof(out));
+}
+
+// Drops least recently used entries down to capacity and returns their number; _mutex must be held.
+std::size_t SecretCache::shrink(std::size_t capacity) {
+    std::size_t dropped = 0;
+    for (; _entries.size() > capacity; ++dropped) {
+        Entry& last = _entries.back();
+        secureZero(last.secret, sizeof(last.secret));
+        _index.erase(last.id);
+        _entries.pop_back();
+    }
+    return dropped;
+}
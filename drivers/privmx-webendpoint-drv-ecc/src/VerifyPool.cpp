@@ -0,0 +1,137 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <privmx/drv/PubkeyCache.hpp>
+#include <privmx/drv/SecpContext.hpp>
+#include <privmx/drv/VerifyPool.hpp>
+
+namespace {
+
+// Items claimed at once; verifying one takes tens of microseconds, far more than claiming it.
+constexpr std::size_t CHUNK = 4;
+
+}  // namespace
+
+struct VerifyPool::Batch {
+    // Only dereferenced for claimed items; the caller may have returned once all are done
+    const Item* items;
+    int* results;
+    std::size_t count;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+VerifyPool& VerifyPool::getInstance() {
+    static VerifyPool pool(std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), MAX_THREADS) - 1);
+    return pool;
+}
+
+VerifyPool::VerifyPool(std::size_t helpers) {
+    for (std::size_t i = 0; i < helpers; ++i) {
+        _helpers.emplace_back([this] { helperLoop(); });
+    }
+}
+
+VerifyPool::~VerifyPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    for (std::thread& helper : _helpers) {
+        if (helper.joinable()) {
+            helper.join();
+        }
+    }
+}
+
+void VerifyPool::verify(const secp256k1_context* ctx, const std::vector<Item>& items, int* results) {
+    auto batch = std::make_shared<Batch>();
+    batch->items = items.data();
+    batch->results = results;
+    batch->count = items.size();
+    if (_helpers.empty() || items.size() < MIN_PARALLEL_ITEMS) {
+        run(ctx, *batch);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(batch);
+    }
+    _cv.notify_all();
+    run(ctx, *batch);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.erase(std::remove(_queue.begin(), _queue.end(), batch), _queue.end());
+    }
+    // Items claimed by helpers may still be in progress
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&] { return batch->done.load() == batch->count; });
+}
+
+void VerifyPool::helperLoop() {
+    SecpContext::init();
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this] { return _stop || !_queue.empty(); });
+            if (_stop) {
+                break;
+            }
+            batch = _queue.front();
+        }
+        secp256k1_context* ctx = SecpContext::get();
+        if (ctx) {
+            run(ctx, *batch);
+        }
+        {
+            // Nothing left to claim; drop it unless another helper or the caller already did
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_queue.empty() && _queue.front() == batch) {
+                _queue.pop_front();
+            }
+        }
+    }
+}
+
+void VerifyPool::run(const secp256k1_context* ctx, Batch& batch) {
+    while (true) {
+        std::size_t begin = batch.next.fetch_add(CHUNK);
+        if (begin >= batch.count) {
+            return;
+        }
+        std::size_t end = std::min(begin + CHUNK, batch.count);
+        for (std::size_t i = begin; i < end; ++i) {
+            batch.results[i] = verifyItem(ctx, batch.items[i]);
+        }
+        if (batch.done.fetch_add(end - begin) + (end - begin) == batch.count) {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            batch.finished.notify_all();
+        }
+    }
+}
+
+int VerifyPool::verifyItem(const secp256k1_context* ctx, const Item& item) {
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+    if ((item.pubkey.size() != 33 && item.pubkey.size() != 65) ||
+        !PubkeyCache::getInstance().parse(ctx, item.pubkey, pubkey) ||
+        !secp256k1_ecdsa_signature_parse_compact(ctx, &sig, item.sig)) {
+        return -1;
+    }
+    secp256k1_ecdsa_signature_normalize(ctx, &sig, &sig);
+    return secp256k1_ecdsa_verify(ctx, &sig, item.msg, &pubkey) == 1 ? 1 : 0;
+}
@@ -18,13 +18,19 @@ limitations under the License.
 #include <secp256k1_ecdh.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "privmx/drv/BNImpl.hpp"
 #include "privmx/drv/ECCImpl.hpp"
 #include "privmx/drv/PointImpl.hpp"
+#include "privmx/drv/PubkeyCache.hpp"
+#include "privmx/drv/SecretCache.hpp"
+#include "privmx/drv/SecpContext.hpp"
+#include "privmx/drv/VerifyPool.hpp"
 
 using namespace std;
 using namespace emscripten;
@@ -41,12 +47,6 @@ struct privmxDrvEcc_ECC {
     std::unique_ptr<ECCImpl> impl;
 };
 
-static secp256k1_context* create_secp_context() {
-    return secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-}
-
-secp256k1_context* ctx = create_secp_context();
-
 int privmxDrvEcc_version(unsigned int* version) {
     if (!version) return 1;
     *version = 1;
@@ -85,7 +85,7 @@ int privmxDrvEcc_bnBitsLength(const privmxDrvEcc_BN* bn, int* res) {
     if (!bn || !bn->impl || !res) {
         return 1;
     }
-    *res = 256;  // bn->impl->getBitsLength();
+    *res = bn->impl->getBitsLength();
     return 0;
 }
 
@@ -172,7 +172,12 @@ int privmxDrvEcc_pointEncode(const privmxDrvEcc_Point* point, int compact, char*
         return 2;
     }
 
-    std::string cpp_str = point->impl->encode(ctx, compact);
+    std::string cpp_str;
+    try {
+        cpp_str = point->impl->encode(SecpContext::get(), compact);
+    } catch (...) {
+        return 4;
+    }
     *outlen = cpp_str.length();
     *out = reinterpret_cast<char*>(malloc(*outlen));
 
@@ -334,6 +339,7 @@ int privmxDrvEcc_eccSign(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, pri
     if (!res) {
         return 3;
     }
+    secp256k1_context* ctx = SecpContext::get();
     if (!ctx) {
         return 4;
     }
@@ -380,6 +386,7 @@ int privmxDrvEcc_eccVerify(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, c
     if (!msg) return 2;
     if (!sig || !sig->r || !sig->r->impl || !sig->s || !sig->s->impl) return 3;
     if (!res) return 4;
+    secp256k1_context* ctx = SecpContext::get();
     if (!ctx) return 5;
 
     *res = 0;
@@ -395,15 +402,12 @@ int privmxDrvEcc_eccVerify(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, c
     memcpy(compact_sig + 64 - s_bytes.length(), s_bytes.data(), s_bytes.length());
 
     std::string pubkey_str = ecc->impl->getPublicKey();
-    const unsigned char* pubkey_bytes = reinterpret_cast<const unsigned char*>(pubkey_str.data());
-    size_t pubkey_len = pubkey_str.length();
-
-    if (pubkey_len != 33 && pubkey_len != 65) {
+    if (pubkey_str.length() != 33 && pubkey_str.length() != 65) {
         return 1;
     }
 
     secp256k1_pubkey pubkey;
-    if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkey_bytes, pubkey_len)) {
+    if (!PubkeyCache::getInstance().parse(ctx, pubkey_str, pubkey)) {
         return 1;
     }
 
@@ -419,6 +423,42 @@ int privmxDrvEcc_eccVerify(privmxDrvEcc_ECC* ecc, const char* msg, int msglen, c
     return 0;
 }
 
+int privmxDrvEcc_eccVerifyBatch(privmxDrvEcc_ECC* const* eccs, const char* const* msgs, const int* msglens,
+                                const privmxDrvEcc_Signature* sigs, unsigned int count, int* results) {
+    if (count && (!eccs || !msgs || !msglens || !sigs || !results)) return 1;
+    secp256k1_context* ctx = SecpContext::get();
+    if (!ctx) return 5;
+
+    try {
+        // Keys and signatures are read here; only the secp256k1 calls run on the pool. Items left without a public key
+        // are reported as -1.
+        std::vector<VerifyPool::Item> items(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            const privmxDrvEcc_Signature& sig = sigs[i];
+            if (!eccs[i] || !eccs[i]->impl || !msgs[i] || msglens[i] != 32 || !sig.r || !sig.r->impl || !sig.s ||
+                !sig.s->impl) {
+                continue;
+            }
+            std::string r_bytes = sig.r->impl->toBuffer();
+            std::string s_bytes = sig.s->impl->toBuffer();
+            if (r_bytes.length() > 32 || s_bytes.length() > 32) {
+                continue;
+            }
+            VerifyPool::Item& item = items[i];
+            memset(item.sig, 0, sizeof(item.sig));
+            memcpy(item.sig + 32 - r_bytes.length(), r_bytes.data(), r_bytes.length());
+            memcpy(item.sig + 64 - s_bytes.length(), s_bytes.data(), s_bytes.length());
+            memcpy(item.msg, msgs[i], 32);
+            item.pubkey = eccs[i]->impl->getPublicKey();
+        }
+
+        VerifyPool::getInstance().verify(ctx, items, results);
+    } catch (...) {
+        return 6;
+    }
+    return std::any_of(results, results + count, [](int result) { return result < 0; }) ? 1 : 0;
+}
+
 int ecdh_x_coordinate_copy_fn(unsigned char* output, const unsigned char* x, const unsigned char* y, void* data) {
     (void)y;
     (void)data;
@@ -436,6 +476,7 @@ int privmxDrvEcc_eccDerive(const privmxDrvEcc_ECC* ecc, const privmxDrvEcc_ECC*
     if (!res || !reslen) {
         return 3;
     }
+    secp256k1_context* ctx = SecpContext::get();
     if (!ctx) {
         return 5;
     }
@@ -457,8 +498,7 @@ int privmxDrvEcc_eccDerive(const privmxDrvEcc_ECC* ecc, const privmxDrvEcc_ECC*
     }
 
     secp256k1_pubkey pubkey_struct;
-    if (secp256k1_ec_pubkey_parse(ctx, &pubkey_struct, reinterpret_cast<const unsigned char*>(pub_key_str.data()),
-                                  pub_key_str.length()) != 1) {
+    if (!PubkeyCache::getInstance().parse(ctx, pub_key_str, pubkey_struct)) {
         return 6;
     }
 
@@ -532,6 +572,74 @@ int privmxDrvEcc_eccFree(privmxDrvEcc_ECC* ecc) {
     return 0;
 }
 
+int privmxDrvEcc_initThread() {
+    return SecpContext::init() ? 0 : 1;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_getContextStats(double* stats) {
+    if (!stats) return 1;
+    SecpContext::Stats current = SecpContext::getStats();
+    stats[0] = static_cast<double>(current.contexts);
+    stats[1] = static_cast<double>(current.randomizations);
+    stats[2] = static_cast<double>(current.failedRandomizations);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_setPubkeyCacheCapacity(unsigned int capacity) {
+    PubkeyCache::getInstance().setCapacity(capacity);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_clearPubkeyCache() {
+    PubkeyCache::getInstance().clear();
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_getPubkeyCacheStats(double* stats, int reset) {
+    if (!stats) return 1;
+    PubkeyCache::Stats current = PubkeyCache::getInstance().getStats();
+    stats[0] = static_cast<double>(current.hits);
+    stats[1] = static_cast<double>(current.misses);
+    stats[2] = static_cast<double>(current.evictions);
+    stats[3] = static_cast<double>(current.size);
+    stats[4] = static_cast<double>(current.capacity);
+    if (reset) {
+        PubkeyCache::getInstance().resetStats();
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_setSecretCacheCapacity(unsigned int capacity) {
+    SecretCache::getInstance().setCapacity(capacity);
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_clearSecretCache() {
+    SecretCache::getInstance().clear();
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int privmxDrvEcc_getSecretCacheStats(double* stats, int reset) {
+    if (!stats) return 1;
+    SecretCache::Stats current = SecretCache::getInstance().getStats();
+    stats[0] = static_cast<double>(current.hits);
+    stats[1] = static_cast<double>(current.misses);
+    stats[2] = static_cast<double>(current.evictions);
+    stats[3] = static_cast<double>(current.size);
+    stats[4] = static_cast<double>(current.capacity);
+    if (reset) {
+        SecretCache::getInstance().resetStats();
+    }
+    return 0;
+}
+
 int privmxDrvEcc_freeMem(void* ptr) {
     free(ptr);
     return 0;
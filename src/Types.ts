@@ -23,6 +23,7 @@ export type SortOrder = "desc" | "asc";
  * @param {string} type event type
  * @param {string} channel channel
  * @param {number} connectionId id of source connection
+ * @param {number[]} [targets] ids of the event filters matching the event (set only when event filters are registered)
  *
  */
 export interface Event {
@@ -33,6 +34,55 @@ export interface Event {
     subscriptions: string[];
     version: number;
     timestamp: number;
+    targets?: number[];
+}
+
+/**
+ * Native event filter, matched before the event is passed to JS
+ *
+ * @type {EventFilter}
+ *
+ * @param {string | string[]} [type] accepted event type(s)
+ * @param {string} [channel] channel prefix, e.g. `thread/<threadId>/messages`
+ * @param {string} [containerId] id of the Context, Thread, Store, Kvdb, Inbox or Stream Room the event relates to
+ * @param {string[]} [subscriptions] subscription ids, at least one of which the event must carry
+ *
+ */
+export interface EventFilter {
+    type?: string | string[];
+    channel?: string;
+    containerId?: string;
+    subscriptions?: string[];
+}
+
+/**
+ * Configuration of native event coalescing
+ *
+ * @type {EventCoalescingConfig}
+ *
+ * @param {number} windowMs time window in which update events for the same item are collapsed; 0 disables coalescing
+ * @param {string[]} [types] event types eligible for coalescing (defaults to entry/message/file/container update events)
+ *
+ */
+export interface EventCoalescingConfig {
+    windowMs: number;
+    types?: string[];
+}
+
+/**
+ * Native event coalescing counters
+ *
+ * @type {EventCoalescingStats}
+ *
+ * @param {number} received number of events that entered the coalescing stage
+ * @param {number} collapsed number of events dropped in favor of a newer event for the same item
+ * @param {number} delivered number of events passed on
+ *
+ */
+export interface EventCoalescingStats {
+    received: number;
+    collapsed: number;
+    delivered: number;
 }
 
 /**
@@ -51,7 +51,15 @@ export class Api {
     }
 
     private setResultsCallback() {
-        this.lib.setResultsCallback((result: any) => this.resolveResult(result));
+        this.lib.setResultsCallback((results: Result | Result[]) => {
+            if (Array.isArray(results)) {
+                for (const result of results) {
+                    this.resolveResult(result);
+                }
+            } else {
+                this.resolveResult(results);
+            }
+        });
     }
 
     private toNativeError(error: unknown): Error {
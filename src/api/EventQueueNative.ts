@@ -9,7 +9,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-import { Event } from "../Types";
+import { Event, EventCoalescingConfig, EventCoalescingStats, EventFilter } from "../Types";
 import { BaseNative } from "./BaseNative";
 
 export class EventQueueNative extends BaseNative {
@@ -36,6 +36,41 @@ export class EventQueueNative extends BaseNative {
             this.api.lib.EventQueue_waitEvent(taskId, ptr, args),
         );
     }
+    async waitEvents(ptr: number, args: [number, number]): Promise<Event[]> {
+        return this.runAsync<Event[]>((taskId) =>
+            this.api.lib.EventQueue_waitEvents(taskId, ptr, args),
+        );
+    }
+    startEventPump(
+        ptr: number,
+        callback: (events: Event[] | null, error?: unknown) => void,
+        args: [number, number],
+    ): boolean {
+        return this.api.lib.EventQueue_startEventPump(ptr, callback, args);
+    }
+    async stopEventPump(ptr: number): Promise<void> {
+        return this.runAsync<void>((taskId) => this.api.lib.EventQueue_stopEventPump(taskId, ptr));
+    }
+    async addEventFilter(ptr: number, args: [EventFilter]): Promise<number> {
+        return this.runAsync<number>((taskId) =>
+            this.api.lib.EventQueue_addEventFilter(taskId, ptr, args),
+        );
+    }
+    async removeEventFilter(ptr: number, args: [number]): Promise<void> {
+        return this.runAsync<void>((taskId) =>
+            this.api.lib.EventQueue_removeEventFilter(taskId, ptr, args),
+        );
+    }
+    async setEventCoalescing(ptr: number, args: [EventCoalescingConfig]): Promise<void> {
+        return this.runAsync<void>((taskId) =>
+            this.api.lib.EventQueue_setEventCoalescing(taskId, ptr, args),
+        );
+    }
+    async getEventCoalescingStats(ptr: number, args: []): Promise<EventCoalescingStats> {
+        return this.runAsync<EventCoalescingStats>((taskId) =>
+            this.api.lib.EventQueue_getEventCoalescingStats(taskId, ptr, args),
+        );
+    }
     async emitBreakEvent(ptr: number, args: []): Promise<void> {
         return this.runAsync<void>((taskId) =>
             this.api.lib.EventQueue_emitBreakEvent(taskId, ptr, args),
@@ -0,0 +1,101 @@
+/**
+ * Upload throughput of FileUploader: chunks sent with sendNextChunk (what uploadFileContent does by
+ * default) against the read-ahead mode at several window sizes.
+ *
+ * writeToFile is a stub for the endpoint library's: every chunk is encrypted (AES-256-CBC) and
+ * checksummed (SHA-256) by WebCrypto off the main thread, then POSTed to a local HTTP server that
+ * reads the whole body before answering. The file is disk-backed, like a File picked in the
+ * browser.
+ *
+ *   npm run bench:upload [-- <size in MiB, default 64>]
+ */
+import { randomBytes } from "node:crypto";
+import { openAsBlob } from "node:fs";
+import { mkdtemp, rm, writeFile } from "node:fs/promises";
+import { createServer, Server } from "node:http";
+import { AddressInfo } from "node:net";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { FILE_DEFAULT_CHUNK_SIZE, FileUploader, FileUploadReadAhead } from "../files";
+
+const MIB = 1_048_576;
+const WINDOWS = [0, 1, 2, 4, 8];
+const RUNS = 3;
+
+function startStubServer(): Promise<Server> {
+    const server = createServer((req, res) => {
+        req.on("data", () => {});
+        req.on("end", () => res.end());
+    });
+    return new Promise((resolve) => server.listen(0, "127.0.0.1", () => resolve(server)));
+}
+
+async function createStubApi(url: string) {
+    const subtle = globalThis.crypto.subtle;
+    const key = await subtle.generateKey({ name: "AES-CBC", length: 256 }, false, ["encrypt"]);
+    const iv = globalThis.crypto.getRandomValues(new Uint8Array(16));
+    return {
+        async writeToFile(chunk: Uint8Array) {
+            const [cipher] = await Promise.all([
+                subtle.encrypt({ name: "AES-CBC", iv }, key, chunk),
+                subtle.digest("SHA-256", chunk),
+            ]);
+            const response = await fetch(url, { method: "POST", body: new Uint8Array(cipher) });
+            await response.arrayBuffer();
+        },
+        async closeFile() {
+            return "fileId";
+        },
+    };
+}
+
+// Best of RUNS uploads, in MiB/s
+async function measure(
+    file: File,
+    api: Awaited<ReturnType<typeof createStubApi>>,
+    readAhead?: FileUploadReadAhead,
+) {
+    let bestMs = Infinity;
+    for (let run = 0; run < RUNS; run++) {
+        const uploader = new FileUploader(file, api, readAhead);
+        const start = performance.now();
+        await uploader.uploadFileContent();
+        bestMs = Math.min(bestMs, performance.now() - start);
+    }
+    return file.size / MIB / (bestMs / 1000);
+}
+
+function printRow(mode: string, mibPerSec: number) {
+    console.log(`${mode.padEnd(24)}${mibPerSec.toFixed(1).padStart(10)}`);
+}
+
+async function main() {
+    const sizeMib = Number(process.argv[2] ?? 64);
+    const dir = await mkdtemp(join(tmpdir(), "privmx-upload-bench-"));
+    const server = await startStubServer();
+    try {
+        const path = join(dir, "upload.bin");
+        await writeFile(path, randomBytes(sizeMib * MIB));
+        const blob: unknown = await openAsBlob(path);
+        const file = new File([blob as Blob], "upload.bin");
+        const api = await createStubApi(
+            `http://127.0.0.1:${(server.address() as AddressInfo).port}/`,
+        );
+
+        console.log(`upload of ${sizeMib} MiB, best of ${RUNS} runs`);
+        console.log(`${"mode".padEnd(24)}${"MiB/s".padStart(10)}`);
+        printRow("sendNextChunk", await measure(file, api));
+        for (const window of WINDOWS) {
+            const readAhead = { window, chunkSize: FILE_DEFAULT_CHUNK_SIZE };
+            printRow(`read-ahead, window ${window}`, await measure(file, api, readAhead));
+        }
+    } finally {
+        server.close();
+        await rm(dir, { recursive: true, force: true });
+    }
+}
+
+main().catch((error) => {
+    console.error(error);
+    process.exitCode = 1;
+});
@@ -36,9 +36,79 @@ export class MockEventQueue {
         return lockPromise;
     }
 
-    async emitBreakEvent() {
-        return new Promise<void>((resolve) => {
-            resolve;
+    // Queued like core's break event, for whichever reader comes next
+    async emitBreakEvent(): Promise<void> {
+        this.dispatchEvent({
+            type: "libBreakEvent",
+            channel: "",
+            connectionId: -1,
+            subscriptions: [],
+            version: 0,
+            timestamp: Date.now(),
         });
     }
 }
+
+export class MockBatchEventQueue extends MockEventQueue {
+    batchSizes: number[] = [];
+
+    async waitEvents(): Promise<Types.Event[]> {
+        const first = await this.waitEvent();
+        const events = [first, ...this.queue.splice(0)];
+        this.batchSizes.push(events.length);
+        return events;
+    }
+}
+
+export class MockPumpEventQueue extends MockBatchEventQueue {
+    pumpCallback: ((events: Types.Event[] | null, error?: unknown) => void) | null = null;
+    pumpStopped = false;
+
+    startEventPump(callback: (events: Types.Event[] | null, error?: unknown) => void): boolean {
+        this.pumpCallback = callback;
+        return true;
+    }
+
+    // Wakes the pump like the native one; the mock pump never reads, so the break event stays
+    async stopEventPump(): Promise<void> {
+        await this.emitBreakEvent();
+        await new Promise((resolve) => setTimeout(resolve, 0));
+        this.pumpCallback = null;
+        this.pumpStopped = true;
+    }
+}
+
+export class MockFilterEventQueue extends MockBatchEventQueue {
+    filters = new Map<number, Types.EventFilter>();
+    private nextFilterId = 1;
+
+    async addEventFilter(filter: Types.EventFilter): Promise<number> {
+        const filterId = this.nextFilterId++;
+        this.filters.set(filterId, filter);
+        return filterId;
+    }
+
+    async removeEventFilter(filterId: number): Promise<void> {
+        this.filters.delete(filterId);
+    }
+
+    // Routes like the native router, by subscription ids only
+    async waitEvents(): Promise<Types.Event[]> {
+        const events = await super.waitEvents();
+        if (this.filters.size === 0) {
+            return events;
+        }
+        return events
+            .map((event) => ({
+                ...event,
+                targets: [...this.filters.entries()]
+                    .filter(
+                        ([, filter]) =>
+                            !filter.subscriptions ||
+                            filter.subscriptions.some((id) => event.subscriptions.includes(id)),
+                    )
+                    .map(([filterId]) => filterId),
+            }))
+            .filter((event) => event.targets.length > 0);
+    }
+}
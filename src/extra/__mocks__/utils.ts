@@ -1,4 +1,9 @@
-import { MockEventQueue } from "./mockEventQueue";
+import {
+    MockBatchEventQueue,
+    MockEventQueue,
+    MockFilterEventQueue,
+    MockPumpEventQueue,
+} from "./mockEventQueue";
 import { EventManager } from "../events";
 
 export async function utils<T>(cb: () => T): Promise<T> {
@@ -13,6 +18,24 @@ export function createTestSetup() {
     return { q, manager: mockEventsManager };
 }
 
+export function createBatchTestSetup() {
+    const q = new MockBatchEventQueue();
+    const mockEventsManager = EventManager.startEventLoop(q);
+    return { q, manager: mockEventsManager };
+}
+
+export function createPumpTestSetup() {
+    const q = new MockPumpEventQueue();
+    const mockEventsManager = EventManager.startEventLoop(q);
+    return { q, manager: mockEventsManager };
+}
+
+export function createFilterTestSetup() {
+    const q = new MockFilterEventQueue();
+    const mockEventsManager = EventManager.startEventLoop(q);
+    return { q, manager: mockEventsManager };
+}
+
 export function waitForNextTick(): Promise<void> {
     return new Promise((resolve) => setTimeout(resolve, 0));
 }
@@ -1,4 +1,11 @@
-import { createTestSetup } from "../__mocks__/utils";
+import {
+    createBatchTestSetup,
+    createFilterTestSetup,
+    createPumpTestSetup,
+    createTestSetup,
+    waitForNextTick,
+} from "../__mocks__/utils";
+import { EventManager } from "../events";
 import { ThreadEventsManager } from "../managers";
 import { createThreadSubscription } from "../subscriptions";
 import { ThreadEventSelectorType, ThreadEventType } from "../../Types";
@@ -92,4 +99,154 @@ describe("Events Helpers", () => {
             }, 0);
         });
     });
+
+    it("should dispatch every event of a drained batch in order", async () => {
+        const { q: batchQueue, manager: batchManager } = createBatchTestSetup();
+        const batchEventsManager = new ThreadEventsManager(new MockContainerSubscriber(batchQueue));
+        batchManager.registerDispatcher(batchEventsManager);
+        const received: number[] = [];
+
+        const sub = createThreadSubscription({
+            type: ThreadEventType.THREAD_STATS,
+            selector: ThreadEventSelectorType.CONTEXT_ID,
+            id: "",
+            callbacks: [(e) => received.push(e.timestamp)],
+        });
+
+        const [subId] = await batchEventsManager.subscribeFor([sub]);
+
+        batchQueue.queue.push(
+            { ...createBaseEvent(subId), type: "threadStatsChanged", channel: "thread", timestamp: 1 },
+            { ...createBaseEvent(subId), type: "threadStatsChanged", channel: "thread", timestamp: 2 },
+        );
+        batchQueue.dispatchEvent({
+            ...createBaseEvent(subId),
+            type: "threadStatsChanged",
+            channel: "thread",
+            timestamp: 3,
+        });
+
+        await waitForNextTick();
+        expect(received).toEqual([1, 2, 3]);
+        expect(batchQueue.batchSizes).toEqual([3]);
+    });
+
+    it("should fall back to polling when the event pump fails", async () => {
+        const { q: pumpQueue, manager: pumpManager } = createPumpTestSetup();
+        const pumpEventsManager = new ThreadEventsManager(new MockContainerSubscriber(pumpQueue));
+        pumpManager.registerDispatcher(pumpEventsManager);
+        const received: number[] = [];
+
+        const sub = createThreadSubscription({
+            type: ThreadEventType.THREAD_STATS,
+            selector: ThreadEventSelectorType.CONTEXT_ID,
+            id: "",
+            callbacks: [(e) => received.push(e.timestamp)],
+        });
+
+        const [subId] = await pumpEventsManager.subscribeFor([sub]);
+
+        pumpQueue.pumpCallback([
+            { ...createBaseEvent(subId), type: "threadStatsChanged", channel: "thread", timestamp: 1 },
+        ]);
+        pumpQueue.pumpCallback(null, new Error("source failed"));
+        await waitForNextTick();
+        await waitForNextTick();
+        expect(pumpQueue.pumpStopped).toBe(true);
+
+        pumpQueue.dispatchEvent({
+            ...createBaseEvent(subId),
+            type: "threadStatsChanged",
+            channel: "thread",
+            timestamp: 2,
+        });
+        await waitForNextTick();
+        expect(received).toEqual([1, 2]);
+    });
+
+    it("should resolve stopEventLoop once the event pump has stopped", async () => {
+        const { q: pumpQueue, manager: pumpManager } = createPumpTestSetup();
+
+        const stopped = pumpManager.stopEventLoop();
+        expect(pumpQueue.pumpStopped).toBe(false);
+        await stopped;
+        expect(pumpQueue.pumpStopped).toBe(true);
+    });
+
+    it("should not dispatch break events left behind by a stopped event pump", async () => {
+        const { q: pumpQueue, manager: pumpManager } = createPumpTestSetup();
+        await pumpManager.stopEventLoop();
+        expect(pumpQueue.queue.map((e) => e.type)).toEqual(["libBreakEvent"]);
+
+        // Another reader of the same queue takes the break event the pump did not consume
+        const pollingManager = EventManager.startEventLoop({ waitEvent: () => pumpQueue.waitEvent() });
+        const pollingEventsManager = new ThreadEventsManager(new MockContainerSubscriber(pumpQueue));
+        pollingManager.registerDispatcher(pollingEventsManager);
+        const dispatch = jest.spyOn(pollingEventsManager, "dispatchEvent");
+        const cb = jest.fn();
+
+        const [subId] = await pollingEventsManager.subscribeFor([
+            createThreadSubscription({
+                type: ThreadEventType.THREAD_STATS,
+                selector: ThreadEventSelectorType.CONTEXT_ID,
+                id: "",
+                callbacks: [cb],
+            }),
+        ]);
+        pumpQueue.dispatchEvent({
+            ...createBaseEvent(subId),
+            type: "threadStatsChanged",
+            channel: "thread",
+        });
+        await waitForNextTick();
+        await waitForNextTick();
+
+        expect(pumpQueue.queue).toEqual([]);
+        expect(dispatch.mock.calls.map(([e]) => e.type)).toEqual(["threadStatsChanged"]);
+        expect(cb).toHaveBeenCalledTimes(1);
+        await pollingManager.stopEventLoop();
+    });
+
+    it("should deliver routed events only to the managers their filters belong to", async () => {
+        const { q: filterQueue, manager: filterManager } = createFilterTestSetup();
+        const firstManager = new ThreadEventsManager(new MockContainerSubscriber(filterQueue));
+        const secondManager = new ThreadEventsManager(new MockContainerSubscriber(filterQueue));
+        filterManager.registerDispatcher(firstManager);
+        filterManager.registerDispatcher(secondManager);
+        const secondDispatch = jest.spyOn(secondManager, "dispatchEvent");
+        const cb = jest.fn();
+
+        const [firstSubId] = await firstManager.subscribeFor([
+            createThreadSubscription({
+                type: ThreadEventType.THREAD_STATS,
+                selector: ThreadEventSelectorType.CONTEXT_ID,
+                id: "",
+                callbacks: [cb],
+            }),
+        ]);
+        const [secondSubId] = await secondManager.subscribeFor([
+            createThreadSubscription({
+                type: ThreadEventType.THREAD_STATS,
+                selector: ThreadEventSelectorType.CONTEXT_ID,
+                id: "",
+                callbacks: [jest.fn()],
+            }),
+        ]);
+        expect([...filterQueue.filters.values()]).toEqual([
+            { subscriptions: [firstSubId] },
+            { subscriptions: [secondSubId] },
+        ]);
+
+        filterQueue.dispatchEvent({
+            ...createBaseEvent(firstSubId),
+            type: "threadStatsChanged",
+            channel: "thread",
+        });
+        await waitForNextTick();
+        expect(cb).toHaveBeenCalledTimes(1);
+        expect(secondDispatch).not.toHaveBeenCalled();
+
+        await firstManager.unsubscribeFrom([firstSubId]);
+        expect([...filterQueue.filters.values()]).toEqual([{ subscriptions: [secondSubId] }]);
+    });
 });
@@ -0,0 +1,112 @@
+import { FileUploader } from "../files";
+
+function makeData(size: number) {
+    const data = new Uint8Array(size);
+    for (let i = 0; i < size; i++) data[i] = (i * 31 + 7) & 0xff;
+    return data;
+}
+
+function makeApi(delayMs = 0) {
+    const written: Uint8Array[] = [];
+    const api = {
+        closeFile: jest.fn(async () => "fileId"),
+        writeToFile: jest.fn(async (chunk: Uint8Array) => {
+            if (delayMs) await new Promise((resolve) => setTimeout(resolve, delayMs));
+            written.push(chunk);
+        }),
+    };
+    return { api, written };
+}
+
+function concat(chunks: Uint8Array[]) {
+    const result = new Uint8Array(chunks.reduce((sum, chunk) => sum + chunk.length, 0));
+    let offset = 0;
+    for (const chunk of chunks) {
+        result.set(chunk, offset);
+        offset += chunk.length;
+    }
+    return result;
+}
+
+describe("FileUploader read-ahead upload", () => {
+    test("writes all chunks in order with the requested chunk size", async () => {
+        const data = makeData(10_000);
+        const { api, written } = makeApi(1);
+        const uploader = new FileUploader(new File([data], "test"), api, {
+            window: 3,
+            chunkSize: 1024,
+        });
+
+        await expect(uploader.uploadFileContent()).resolves.toBe("fileId");
+
+        expect(written.map((chunk) => chunk.length)).toEqual([
+            1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 784,
+        ]);
+        expect(concat(written)).toEqual(data);
+        expect(uploader.progress).toBe(100);
+        expect(api.closeFile).toHaveBeenCalledTimes(1);
+    });
+
+    test("keeps at most window chunks read ahead of the one being written", async () => {
+        const data = makeData(64 * 100);
+        let reads = 0;
+        let maxAhead = 0;
+        const { api, written } = makeApi(1);
+        const file = new File([data], "test");
+        const slice = file.slice.bind(file);
+        jest.spyOn(file, "slice").mockImplementation((start, end) => {
+            reads++;
+            maxAhead = Math.max(maxAhead, reads - written.length);
+            return slice(start, end);
+        });
+
+        const uploader = new FileUploader(file, api, { window: 2, chunkSize: 64 });
+        await uploader.uploadFileContent();
+
+        expect(written.length).toBe(100);
+        expect(concat(written)).toEqual(data);
+        // the chunk being written plus the window
+        expect(maxAhead).toBe(3);
+    });
+
+    test("continues after chunks sent with sendNextChunk", async () => {
+        const data = makeData(300_000);
+        const { api, written } = makeApi();
+        const uploader = new FileUploader(new File([data], "test"), api, { chunkSize: 50_000 });
+
+        await uploader.sendNextChunk();
+        await uploader.uploadFileContent();
+
+        expect(concat(written)).toEqual(data);
+    });
+
+    test("uploads an empty file", async () => {
+        const { api } = makeApi();
+        const uploader = new FileUploader(new File([], "empty"), api, {});
+
+        await expect(uploader.uploadFileContent()).resolves.toBe("fileId");
+        expect(api.writeToFile).not.toHaveBeenCalled();
+    });
+
+    test("stops at the first failed write", async () => {
+        const data = makeData(4096);
+        const api = {
+            closeFile: jest.fn(async () => "fileId"),
+            writeToFile: jest.fn(async () => {
+                throw new Error("write failed");
+            }),
+        };
+        const uploader = new FileUploader(new File([data], "test"), api, { chunkSize: 1024 });
+
+        await expect(uploader.uploadFileContent()).rejects.toThrow("write failed");
+        expect(api.writeToFile).toHaveBeenCalledTimes(1);
+        expect(uploader.progress).toBe(0);
+    });
+
+    test("rejects an invalid window or chunk size", () => {
+        const { api } = makeApi();
+        const file = new File([makeData(10)], "test");
+        expect(() => new FileUploader(file, api, { window: -1 })).toThrow(RangeError);
+        expect(() => new FileUploader(file, api, { chunkSize: 0 })).toThrow(RangeError);
+    });
+});
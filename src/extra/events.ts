@@ -20,6 +20,9 @@ import {
     UserEventsManager,
 } from "./managers";
 
+// Only wakes up a blocked reader (emitBreakEvent, stopEventPump); never meant for subscribers
+const BREAK_EVENT_TYPE = "libBreakEvent";
+
 function normalizeConnectionEvent(e: Types.Event): Types.Event {
     switch (e.type) {
         case "libDisconnected":
@@ -48,19 +51,39 @@ function normalizeConnectionEvent(e: Types.Event): Types.Event {
     }
 }
 
+interface EventSource {
+    waitEvent: () => Promise<Types.Event>;
+    waitEvents?: () => Promise<Types.Event[]>;
+    startEventPump?: (callback: (events: Types.Event[] | null, error?: unknown) => void) => boolean;
+    stopEventPump?: () => Promise<void>;
+    addEventFilter?: (filter: Types.EventFilter) => Promise<number>;
+    removeEventFilter?: (filterId: number) => Promise<void>;
+}
+
 export class EventManager {
     private _isEventLoopRunning = false;
+    private _isEventPumpRunning = false;
+    private eventPumpStopped: Promise<void> = Promise.resolve();
     dispatchers: ((event: Types.Event) => void)[] = [];
-    private eventsQueue: { waitEvent: () => Promise<Types.Event> } | null = null;
+    private managers: BaseEventDispatcherManager[] = [];
+    // Dispatcher of every native filter registered by the managers, by filter id
+    private filterTargets = new Map<number, (event: Types.Event) => void>();
+    private eventsQueue: EventSource | null = null;
 
     constructor() {}
 
+    private nextEvents(): Promise<Types.Event[]> {
+        if (this.eventsQueue.waitEvents) {
+            return this.eventsQueue.waitEvents();
+        }
+        return this.eventsQueue.waitEvent().then((event) => [event]);
+    }
+
     private listenForEvents() {
         if (this.eventsQueue) {
-            this.eventsQueue
-                .waitEvent()
-                .then((event) => {
-                    this.onEvent(event);
+            this.nextEvents()
+                .then((events) => {
+                    events.forEach((event) => this.onEvent(event));
                     this.listenForEvents();
                 })
                 .catch(() => {
@@ -69,41 +92,102 @@ export class EventManager {
         }
     }
 
-    static startEventLoop(eventQueue: { waitEvent: () => Promise<Types.Event> }) {
+    private pollEvents() {
+        this.nextEvents()
+            .then((events) => {
+                if (!this._isEventLoopRunning) return;
+                events.forEach((event) => this.onEvent(event));
+                this.listenForEvents();
+            })
+            .catch(() => {
+                this.listenForEvents();
+            });
+    }
+
+    private stopEventPump(): Promise<void> {
+        if (this._isEventPumpRunning) {
+            this._isEventPumpRunning = false;
+            this.eventPumpStopped = this.eventsQueue.stopEventPump().catch(() => {});
+        }
+        return this.eventPumpStopped;
+    }
+
+    static startEventLoop(eventQueue: EventSource) {
         const manager = new EventManager();
 
         manager.eventsQueue = eventQueue;
 
         manager._isEventLoopRunning = true;
 
-        manager.eventsQueue
-            .waitEvent()
-            .then((event) => {
+        if (eventQueue.startEventPump) {
+            manager._isEventPumpRunning = eventQueue.startEventPump((events) => {
                 if (!manager._isEventLoopRunning) return;
-                manager.onEvent(event);
-                manager.listenForEvents();
-            })
-            .catch(() => {
-                manager.listenForEvents();
+                if (events) {
+                    events.forEach((event) => manager.onEvent(event));
+                    return;
+                }
+                // The pump failed and exited; release it, then keep receiving events by polling.
+                manager.stopEventPump().then(() => {
+                    if (manager._isEventLoopRunning) manager.pollEvents();
+                });
             });
+            if (manager._isEventPumpRunning) {
+                return manager;
+            }
+        }
+
+        manager.pollEvents();
 
         return manager;
     }
 
-    stopEventLoop() {
+    /**
+     * Stops delivering events. The returned promise resolves once the event pump, if used,
+     * has been stopped, so a new event loop can be started on the same queue right after.
+     */
+    stopEventLoop(): Promise<void> {
         this._isEventLoopRunning = false;
+        return this.stopEventPump();
     }
 
     removeAllDispatchers = (): void => {
         this.dispatchers = [];
+        this.managers.forEach((manager) => manager.attachEventFilters(null));
+        this.managers = [];
     };
 
     protected onEvent(event: Types.Event) {
-        this.dispatchers.forEach((cb) => cb(normalizeConnectionEvent(event)));
+        if (event.type === BREAK_EVENT_TYPE) {
+            return;
+        }
+        const normalized = normalizeConnectionEvent(event);
+        if (event.targets) {
+            // Routed natively: only the dispatchers whose filters matched get the event, each once
+            const targets = new Set(event.targets.map((id) => this.filterTargets.get(id)));
+            targets.forEach((cb) => cb?.(normalized));
+            return;
+        }
+        this.dispatchers.forEach((cb) => cb(normalized));
     }
 
     registerDispatcher(manager: BaseEventDispatcherManager) {
-        this.dispatchers.push((e) => manager.dispatchEvent(e));
+        const dispatcher = (e: Types.Event) => manager.dispatchEvent(e);
+        this.dispatchers.push(dispatcher);
+        this.managers.push(manager);
+        const queue = this.eventsQueue;
+        if (queue?.addEventFilter && queue.removeEventFilter) {
+            manager.attachEventFilters({
+                addEventFilter: async (filter) => {
+                    const filterId = await queue.addEventFilter(filter);
+                    this.filterTargets.set(filterId, dispatcher);
+                    return filterId;
+                },
+                removeEventFilter: async (filterId) => {
+                    await queue.removeEventFilter(filterId);
+                    this.filterTargets.delete(filterId);
+                },
+            });
+        }
     }
 
     getThreadEventManager(threadApi: SubscriberForThreadsEvents) {
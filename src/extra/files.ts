@@ -109,10 +109,29 @@ interface FileContainerApi {
     closeFile: () => Promise<string>;
 }
 
+/**
+ * Read-ahead upload mode of {@link FileUploader `FileUploader`}.
+ *
+ * The file is read in `chunkSize` slices, up to `window` of them ahead of the one being written,
+ * so reading the next chunks overlaps with encrypting and sending the current one. The window
+ * bounds the memory held by an upload to `(window + 1) * chunkSize` bytes. Chunks are still
+ * encrypted and sent one at a time, in order, by the file handle's `writeToFile`.
+ */
+export interface FileUploadReadAhead {
+    /** Number of chunks read ahead of the one being written (default 1). */
+    window?: number;
+    /** Size of the chunks passed to `writeToFile` (default {@link FILE_DEFAULT_CHUNK_SIZE}). */
+    chunkSize?: number;
+}
+
+export const FILE_DEFAULT_READ_AHEAD_WINDOW = 1;
+
 export class FileUploader {
     private readonly _size: number;
     private offset: number = 0;
     private readonly _api: FileContainerApi;
+    private readonly _file: File;
+    private readonly _readAhead?: Required<FileUploadReadAhead>;
 
     private _reader: ReadableStreamDefaultReader<Uint8Array>;
 
@@ -122,12 +141,25 @@ export class FileUploader {
      * @param {number} handle - The file handle.
      * @param {File} file - The data (file content) to upload.
      * @param {StoreApi} api {@link StoreApi `StoreApi`} instance
+     * @param {FileUploadReadAhead} [readAhead] enables the read-ahead mode of `uploadFileContent`
      */
 
-    constructor(file: File, api: FileContainerApi) {
+    constructor(file: File, api: FileContainerApi, readAhead?: FileUploadReadAhead) {
         this._size = file.size;
         this._api = api;
+        this._file = file;
         this._reader = file.stream().getReader();
+        if (readAhead) {
+            const window = readAhead.window ?? FILE_DEFAULT_READ_AHEAD_WINDOW;
+            const chunkSize = readAhead.chunkSize ?? FILE_DEFAULT_CHUNK_SIZE;
+            if (!Number.isInteger(window) || window < 0) {
+                throw new RangeError("Read-ahead window must be a non-negative integer");
+            }
+            if (!Number.isInteger(chunkSize) || chunkSize <= 0) {
+                throw new RangeError("Read-ahead chunk size must be a positive integer");
+            }
+            this._readAhead = { window, chunkSize };
+        }
     }
 
     static async uploadStoreFile({
@@ -136,12 +168,14 @@ export class FileUploader {
         file,
         privateMeta,
         publicMeta,
+        readAhead,
     }: {
         storeId: string;
         file: File;
         storeApi: StoreApi;
         publicMeta?: Uint8Array;
         privateMeta?: Uint8Array;
+        readAhead?: FileUploadReadAhead;
     }) {
         const meta = {
             publicMeta: publicMeta || new Uint8Array(),
@@ -155,14 +189,18 @@ export class FileUploader {
             file.size,
         );
 
-        const streamer = new FileUploader(file, {
-            closeFile() {
-                return storeApi.closeFile(handle);
-            },
-            writeToFile(chunk) {
-                return storeApi.writeToFile(handle, chunk);
+        const streamer = new FileUploader(
+            file,
+            {
+                closeFile() {
+                    return storeApi.closeFile(handle);
+                },
+                writeToFile(chunk) {
+                    return storeApi.writeToFile(handle, chunk);
+                },
             },
-        });
+            readAhead,
+        );
         return streamer;
     }
 
@@ -170,19 +208,25 @@ export class FileUploader {
         inboxApi,
         inboxHandle,
         preparedFileUpload,
+        readAhead,
     }: {
         inboxHandle: number;
         preparedFileUpload: { file: File; handle: number };
         inboxApi: InboxApi;
+        readAhead?: FileUploadReadAhead;
     }) {
-        const streamer = new FileUploader(preparedFileUpload.file, {
-            closeFile() {
-                return Promise.resolve("");
+        const streamer = new FileUploader(
+            preparedFileUpload.file,
+            {
+                closeFile() {
+                    return Promise.resolve("");
+                },
+                writeToFile(chunk) {
+                    return inboxApi.writeToFile(inboxHandle, preparedFileUpload.handle, chunk);
+                },
             },
-            writeToFile(chunk) {
-                return inboxApi.writeToFile(inboxHandle, preparedFileUpload.handle, chunk);
-            },
-        });
+            readAhead,
+        );
         return streamer;
     }
 
@@ -237,11 +281,50 @@ export class FileUploader {
         return true;
     }
 
+    /**
+     * Uploads the rest of the file and closes the file handle. In read-ahead mode the next chunks
+     * are read while the current one is written; chunks are still written one at a time, in order.
+     *
+     * @returns {Promise<string>} A promise that resolves when the file handle is closed and returns file ID.
+     */
     public async uploadFileContent() {
-        while (await this.sendNextChunk()) {}
+        if (this._readAhead) {
+            await this.uploadWithReadAhead(this._readAhead);
+        } else {
+            while (await this.sendNextChunk()) {}
+        }
         return this.close();
     }
 
+    private async uploadWithReadAhead({ window, chunkSize }: Required<FileUploadReadAhead>) {
+        const pending: Promise<Uint8Array>[] = [];
+        let readOffset = this.offset;
+        const readAhead = () => {
+            while (pending.length <= window && readOffset < this._size) {
+                const end = Math.min(readOffset + chunkSize, this._size);
+                const read = this._file
+                    .slice(readOffset, end)
+                    .arrayBuffer()
+                    .then((buffer) => new Uint8Array(buffer));
+                // reads left behind by a failed write must not surface as unhandled rejections
+                read.catch(() => {});
+                pending.push(read);
+                readOffset = end;
+            }
+        };
+
+        for (;;) {
+            readAhead();
+            const read = pending.shift();
+            if (!read) {
+                break;
+            }
+            const chunk = await read;
+            await this._api.writeToFile(chunk);
+            this.offset += chunk.length;
+        }
+    }
+
     /**
      * Aborts the uploading process, closes the file handle, and deletes the uploaded part of the file.
      *
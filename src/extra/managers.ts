@@ -66,9 +66,21 @@ export interface GenericEvent<K> extends Types.Event {
     data: K;
 }
 
+/**
+ * Native event filters of the event queue a manager is registered with.
+ */
+export interface EventFilterRegistry {
+    addEventFilter(filter: Types.EventFilter): Promise<number>;
+    removeEventFilter(filterId: number): Promise<void>;
+}
+
 export abstract class BaseEventDispatcherManager {
     private _listenersSymbols = new Map<Symbol, string>();
     private _listeners = new Map<string, EventCallback[]>();
+    private _pendingSubscriptions = 0;
+    private _eventFilters: EventFilterRegistry | null = null;
+    private _eventFilter: { registry: EventFilterRegistry; id: number } | null = null;
+    private _eventFilterUpdate: Promise<void> = Promise.resolve();
 
     get listeners() {
         return this._listeners;
@@ -77,6 +89,45 @@ export abstract class BaseEventDispatcherManager {
     protected abstract apiSubscribeFor(strings: string[]): Promise<string[]>;
     protected abstract apiUnsubscribeFrom(strings: string[]): Promise<void>;
 
+    /**
+     * Native filter matching the events this manager has listeners for, or `null` if it needs none.
+     */
+    protected eventFilter(): Types.EventFilter | null {
+        if (this._pendingSubscriptions > 0) {
+            // Subscription ids are not known yet, so nothing may be filtered out meanwhile
+            return {};
+        }
+        return this._listeners.size > 0 ? { subscriptions: [...this._listeners.keys()] } : null;
+    }
+
+    /**
+     * Keeps a native filter for this manager registered in `registry`, so the router only passes
+     * the events it has listeners for.
+     */
+    attachEventFilters(registry: EventFilterRegistry | null): Promise<void> {
+        this._eventFilters = registry;
+        return this.updateEventFilter();
+    }
+
+    protected updateEventFilter(): Promise<void> {
+        // Serialized, so concurrent updates cannot leave a stale filter registered
+        this._eventFilterUpdate = this._eventFilterUpdate
+            .then(() => this.replaceEventFilter())
+            .catch(() => {});
+        return this._eventFilterUpdate;
+    }
+
+    private async replaceEventFilter() {
+        const previous = this._eventFilter;
+        const registry = this._eventFilters;
+        const filter = registry ? this.eventFilter() : null;
+        // The new filter goes in before the old one is removed, so no event is dropped in between
+        this._eventFilter = filter ? { registry, id: await registry.addEventFilter(filter) } : null;
+        if (previous) {
+            await previous.registry.removeEventFilter(previous.id);
+        }
+    }
+
     dispatchEvent(event: Types.Event) {
         const callbacks = event.subscriptions.flatMap((s) => {
             const listeners = this._listeners.get(s);
@@ -88,6 +139,11 @@ export abstract class BaseEventDispatcherManager {
     }
 
     unregisterCallback(symbol: Symbol) {
+        this.removeListener(symbol);
+        this.updateEventFilter();
+    }
+
+    private removeListener(symbol: Symbol) {
         this._listenersSymbols.delete(symbol);
         for (const keys of this._listeners.keys()) {
             const listeners = this._listeners.get(keys);
@@ -107,7 +163,17 @@ export abstract class BaseEventDispatcherManager {
         channelList: string[],
         subscriptions: { callbacks: EventCallback[] }[],
     ) {
-        const subscriptionIds = await this.apiSubscribeFor(channelList);
+        this._pendingSubscriptions++;
+        let subscriptionIds: string[];
+        try {
+            await this.updateEventFilter();
+            subscriptionIds = await this.apiSubscribeFor(channelList);
+        } catch (error) {
+            this._pendingSubscriptions--;
+            await this.updateEventFilter();
+            throw error;
+        }
+        this._pendingSubscriptions--;
 
         subscriptionIds.forEach((id, i) => {
             const subscription = subscriptions[i];
@@ -117,6 +183,7 @@ export abstract class BaseEventDispatcherManager {
             }
             return subscription;
         });
+        await this.updateEventFilter();
         return subscriptionIds;
     }
 
@@ -126,13 +193,14 @@ export abstract class BaseEventDispatcherManager {
             for (const [key, callbackSubscription] of this._listenersSymbols.entries()) {
                 if (callbackSubscription === subscriptionId) {
                     knownIds.push(subscriptionId);
-                    this.unregisterCallback(key);
+                    this.removeListener(key);
                 }
             }
         }
         if (knownIds.length === 0) {
             return Promise.resolve();
         }
+        await this.updateEventFilter();
         return this.apiUnsubscribeFrom(knownIds);
     }
 }
@@ -277,6 +345,13 @@ export class ConnectionEventsManager extends BaseEventDispatcherManager {
         return Promise.resolve();
     }
 
+    protected override eventFilter(): Types.EventFilter | null {
+        // Connection status events carry no subscription ids
+        return this.listeners.size > 0
+            ? { type: ["libConnected", "libDisconnected", "libPlatformDisconnected"] }
+            : null;
+    }
+
     async subscribeFor(subscriptions: ConnectionSubscription[]) {
         const subscriptionChannels = subscriptions.map((x) => {
             return `${this.connectionId}/${ConnectionChannels[x.type]}`;
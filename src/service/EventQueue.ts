@@ -11,10 +11,11 @@ limitations under the License.
 
 import { BaseApi } from "./BaseApi";
 import { EventQueueNative } from "../api/EventQueueNative";
-import { Event } from "../Types";
+import { Event, EventCoalescingConfig, EventCoalescingStats, EventFilter } from "../Types";
 
 export class EventQueue extends BaseApi {
     private deferedPromise: Promise<Event>;
+    private deferedBatchPromise: Promise<Event[]>;
     constructor(
         private native: EventQueueNative,
         ptr: number,
@@ -30,6 +31,90 @@ export class EventQueue extends BaseApi {
         return this.deferedPromise;
     }
 
+    /**
+     * Waits for at least one event, then returns up to `maxBatch` events that are already queued
+     * (or arrive within `lingerMs`) as a single array. Break events are not returned: `emitBreakEvent`
+     * makes it resolve early, with an empty array if nothing else was queued.
+     *
+     * @param {number} [maxBatch=64] maximum number of events returned at once
+     * @param {number} [lingerMs=0] time to wait for more events after the first one arrived
+     * @returns {Promise<Event[]>} batch of events, in the order they were queued
+     */
+    async waitEvents(maxBatch: number = 64, lingerMs: number = 0): Promise<Event[]> {
+        if (!this.deferedBatchPromise) {
+            this.deferedBatchPromise = this.native.waitEvents(this.servicePtr, [maxBatch, lingerMs]);
+            this.deferedBatchPromise.finally(() => (this.deferedBatchPromise = null));
+        }
+        return this.deferedBatchPromise;
+    }
+
+    /**
+     * Starts pushing events to `callback` from a dedicated native thread, in batches,
+     * instead of polling with `waitEvent`. Only one pump can run at a time.
+     *
+     * @param {(events: Event[] | null, error?: unknown) => void} callback receives every batch of events;
+     * if reading events fails, it is called once with `null` and the error, and the pump has to be stopped
+     * @param {number} [maxBatch=64] maximum number of events delivered at once
+     * @param {number} [lingerMs=0] time to wait for more events after the first one arrived
+     * @returns {boolean} `false` if the pump was already running or is still stopping
+     */
+    startEventPump(
+        callback: (events: Event[] | null, error?: unknown) => void,
+        maxBatch: number = 64,
+        lingerMs: number = 0,
+    ): boolean {
+        return this.native.startEventPump(this.servicePtr, callback, [maxBatch, lingerMs]);
+    }
+
+    /**
+     * Stops the event pump started with `startEventPump`. Resolves once its thread has exited,
+     * so a new pump can be started right after.
+     */
+    async stopEventPump(): Promise<void> {
+        return this.native.stopEventPump(this.servicePtr);
+    }
+
+    /**
+     * Registers a native event filter on this EventQueue instance. Once any filter is registered, its
+     * `waitEvents` and event pump only return events matching at least one filter, each with `targets`
+     * listing the matching filter ids. Other EventQueue instances are not affected.
+     *
+     * @param {EventFilter} filter event type(s), channel prefix, container id and/or subscription ids to match
+     * @returns {Promise<number>} id of the registered filter
+     */
+    async addEventFilter(filter: EventFilter): Promise<number> {
+        return this.native.addEventFilter(this.servicePtr, [filter]);
+    }
+
+    /**
+     * Removes a filter registered with `addEventFilter`.
+     *
+     * @param {number} filterId id of the filter to remove
+     */
+    async removeEventFilter(filterId: number): Promise<void> {
+        return this.native.removeEventFilter(this.servicePtr, [filterId]);
+    }
+
+    /**
+     * Enables (or, with `windowMs` set to 0, disables) coalescing of update events in `waitEvents`
+     * and the event pump. Within the window only the latest event per event type, item, connection and
+     * subscriptions is delivered.
+     *
+     * @param {EventCoalescingConfig} config coalescing window and eligible event types
+     */
+    async setEventCoalescing(config: EventCoalescingConfig): Promise<void> {
+        return this.native.setEventCoalescing(this.servicePtr, [config]);
+    }
+
+    /**
+     * Gets the counters of the event coalescing stage.
+     *
+     * @returns {Promise<EventCoalescingStats>} numbers of received, collapsed and delivered events
+     */
+    async getEventCoalescingStats(): Promise<EventCoalescingStats> {
+        return this.native.getEventCoalescingStats(this.servicePtr, []);
+    }
+
     async emitBreakEvent(): Promise<void> {
         return this.native.emitBreakEvent(this.servicePtr, []);
     }
@@ -30,6 +30,13 @@ void EventQueue_deleteEventQueue(int taskId, int ptr);
 API_FUNCTION_HEADER(EventQueue, emitBreakEvent)
 API_FUNCTION_HEADER(EventQueue, waitEvent)
 API_FUNCTION_HEADER(EventQueue, getEvent)
+void EventQueue_waitEvents(int taskId, int ptr, emscripten::val args);
+bool EventQueue_startEventPump(int ptr, emscripten::val callback, emscripten::val args);
+void EventQueue_stopEventPump(int taskId, int ptr);
+void EventQueue_addEventFilter(int taskId, int ptr, emscripten::val args);
+void EventQueue_removeEventFilter(int taskId, int ptr, emscripten::val args);
+void EventQueue_setEventCoalescing(int taskId, int ptr, emscripten::val args);
+void EventQueue_getEventCoalescingStats(int taskId, int ptr, emscripten::val args);
 
 void Connection_newConnection(int taskId);
 void Connection_deleteConnection(int taskId, int ptr);
@@ -0,0 +1,73 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_WEBENDPOINT_EVENTCOALESCER_HPP_
+#define _PRIVMXLIB_WEBENDPOINT_EVENTCOALESCER_HPP_
+
+#include <Poco/Dynamic/Var.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace privmx {
+namespace webendpoint {
+
+/**
+ * @class EventCoalescer
+ * @brief Collapses bursts of update events for the same item into the latest one.
+ * * Events collected within the configured window are grouped by (type, itemId, connectionId, subscriptions)
+ * and only the last event of each group is kept, at the position of its last occurrence. Events of other
+ * types are left alone.
+ * Disabled (window of 0 ms) by default.
+ */
+class EventCoalescer {
+public:
+    struct Config {
+        int windowMs = 0;            ///< Collection window; 0 disables coalescing.
+        std::set<std::string> types;  ///< Event types eligible for coalescing.
+    };
+
+    struct Stats {
+        uint64_t received;   ///< Events that entered the coalescer.
+        uint64_t collapsed;  ///< Events dropped because a newer event for the same item and listeners followed.
+    };
+
+    EventCoalescer();
+
+    /**
+     * @brief Applies a `{windowMs, types?}` object; `types` defaults to the entry/container update events.
+     */
+    void configure(const Poco::Dynamic::Var& config);
+    int windowMs();
+    Poco::JSON::Array::Ptr coalesce(const Poco::JSON::Array::Ptr& events);
+    Stats getStats() const;
+    Poco::Dynamic::Var getStatsVar() const;
+
+private:
+    static std::string getItemId(const Poco::JSON::Object::Ptr& event);
+    static std::string getDeliveryKey(const Poco::JSON::Object::Ptr& event);
+    static std::set<std::string> defaultTypes();
+
+    std::mutex _mutex;
+    Config _config;
+    std::atomic<uint64_t> _received{0};
+    std::atomic<uint64_t> _collapsed{0};
+};
+
+}  // namespace webendpoint
+}  // namespace privmx
+
+#endif  // _PRIVMXLIB_WEBENDPOINT_EVENTCOALESCER_HPP_
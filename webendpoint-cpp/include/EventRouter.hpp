@@ -0,0 +1,80 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _PRIVMXLIB_WEBENDPOINT_EVENTROUTER_HPP_
+#define _PRIVMXLIB_WEBENDPOINT_EVENTROUTER_HPP_
+
+#include <Poco/Dynamic/Var.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace privmx {
+namespace webendpoint {
+
+/**
+ * @class EventRouter
+ * @brief Matches serialized events against per-subscriber filters before they are mapped to JS.
+ * * While no filter is registered, events pass through untouched. Once filters exist, events that no
+ * subscriber wants are dropped and every remaining event gets a `targets` array with the ids of the
+ * subscribers it should be delivered to.
+ */
+class EventRouter {
+public:
+    struct Filter {
+        std::vector<std::string> types;          ///< Accepted event types; empty accepts any type.
+        std::string channel;                     ///< Channel prefix; empty accepts any channel.
+        std::string containerId;                 ///< Container id in the channel or event data; empty accepts any.
+        std::vector<std::string> subscriptions;  ///< Subscription ids, one of which the event must carry.
+    };
+
+    /**
+     * @brief Builds a filter from a `{type?, channel?, containerId?, subscriptions?}` object, `type` being a string
+     * or an array.
+     */
+    static Filter parseFilter(const Poco::Dynamic::Var& filter);
+
+    /**
+     * @brief Removes `libBreakEvent`s, which only wake up a blocked reader and are never delivered to JS.
+     * @param events Array of serialized events, as returned by `EventQueueVarInterface`.
+     * @param found Set to whether any break event was removed.
+     * @return The remaining events, in their original order.
+     */
+    static Poco::JSON::Array::Ptr dropBreakEvents(const Poco::JSON::Array::Ptr& events, bool& found);
+
+    int addSubscriber(const Filter& filter);
+    void removeSubscriber(int subscriberId);
+
+    /**
+     * @brief Filters and annotates a batch of serialized events.
+     * @param events Array of serialized events, as returned by `EventQueueVarInterface`.
+     * @return Events to deliver, in their original order.
+     */
+    Poco::JSON::Array::Ptr route(const Poco::JSON::Array::Ptr& events);
+
+private:
+    static bool matches(const Filter& filter, const Poco::JSON::Object::Ptr& event);
+    static bool containsSubscription(const Poco::JSON::Object::Ptr& event, const std::vector<std::string>& ids);
+    static bool containsContainerId(const Poco::JSON::Object::Ptr& event, const std::string& containerId);
+
+    std::mutex _mutex;
+    int _nextSubscriberId = 1;
+    std::map<int, Filter> _subscribers;
+};
+
+}  // namespace webendpoint
+}  // namespace privmx
+
+#endif  // _PRIVMXLIB_WEBENDPOINT_EVENTROUTER_HPP_
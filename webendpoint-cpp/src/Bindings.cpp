@@ -22,6 +22,13 @@ EMSCRIPTEN_BINDINGS(webendpoint) {
     BINDING_FUNCTION(EventQueue, emitBreakEvent)
     BINDING_FUNCTION(EventQueue, waitEvent)
     BINDING_FUNCTION(EventQueue, getEvent)
+    BINDING_FUNCTION(EventQueue, waitEvents)
+    BINDING_FUNCTION(EventQueue, startEventPump)
+    BINDING_FUNCTION(EventQueue, stopEventPump)
+    BINDING_FUNCTION(EventQueue, addEventFilter)
+    BINDING_FUNCTION(EventQueue, removeEventFilter)
+    BINDING_FUNCTION(EventQueue, setEventCoalescing)
+    BINDING_FUNCTION(EventQueue, getEventCoalescingStats)
 
     BINDING_FUNCTION(Connection, newConnection)
     BINDING_FUNCTION(Connection, deleteConnection)
@@ -11,9 +11,18 @@ limitations under the License.
 
 #include "Endpoint.hpp"
 
+#include <Poco/JSON/Array.h>
 #include <emscripten/proxying.h>
 #include <emscripten/threading.h>
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <privmx/drv/ecc.h>
 #include <privmx/endpoint/core/UserVerifierInterface.hpp>
 #include <privmx/endpoint/core/varinterface/ConnectionVarInterface.hpp>
 #include <privmx/endpoint/core/varinterface/EventQueueVarInterface.hpp>
@@ -27,6 +36,8 @@ limitations under the License.
 
 #include "AsyncEngine.hpp"
 #include "CustomUserVerifierInterface.hpp"
+#include "EventCoalescer.hpp"
+#include "EventRouter.hpp"
 #include "Macros.hpp"
 #include "Mapper.hpp"
 #include "WebRtcInterfaceImpl.hpp"
@@ -52,6 +63,79 @@ using StreamApiVar = privmx::endpoint::stream::StreamApiLowVarInterface;
 using UserVerifierInterface = privmx::endpoint::core::UserVerifierInterface;
 using VerificationRequest = privmx::endpoint::core::VerificationRequest;
 
+namespace {
+
+Poco::Dynamic::Var noArgs() {
+    return Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+}
+
+// Delivery stages of one EventQueue instance: filters and coalescing set through one do not affect the others.
+struct EventStages {
+    EventRouter router;
+    EventCoalescer coalescer;
+};
+
+std::mutex eventStagesMutex;
+std::map<int, std::shared_ptr<EventStages>> eventStagesByQueue;
+
+std::shared_ptr<EventStages> eventStages(int ptr) {
+    std::lock_guard<std::mutex> lock(eventStagesMutex);
+    std::shared_ptr<EventStages>& stages = eventStagesByQueue[ptr];
+    if (!stages) {
+        stages = std::make_shared<EventStages>();
+    }
+    return stages;
+}
+
+void releaseEventStages(int ptr) {
+    std::lock_guard<std::mutex> lock(eventStagesMutex);
+    eventStagesByQueue.erase(ptr);
+}
+
+// Moves already queued events to events, up to maxBatch of them in total.
+void drainEvents(EventQueueVar* eventQueue, const Poco::JSON::Array::Ptr& events, size_t maxBatch) {
+    while (events->size() < maxBatch) {
+        Poco::Dynamic::Var event = eventQueue->getEvent(noArgs());
+        if (event.isEmpty()) {
+            return;
+        }
+        events->add(event);
+    }
+}
+
+// Blocks until the first event arrives, then collects whatever else is already queued (or arrives within
+// lingerMs) up to maxBatch events, so a burst of events costs a single task and a single result.
+// Core's queue has no timed wait, only the blocking waitEvent and the non-blocking getEvent, so instead of
+// polling through the linger window the thread sleeps through it once and then takes what arrived meanwhile.
+Poco::JSON::Array::Ptr collectEvents(EventQueueVar* eventQueue, size_t maxBatch, int lingerMs) {
+    Poco::JSON::Array::Ptr events = new Poco::JSON::Array();
+    events->add(eventQueue->waitEvent(noArgs()));
+    drainEvents(eventQueue, events, maxBatch);
+    if (lingerMs > 0 && events->size() < maxBatch) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(lingerMs));
+        drainEvents(eventQueue, events, maxBatch);
+    }
+    return events;
+}
+
+// Like collectEvents, but coalesces the batch and only returns once at least one event survived the router's
+// filters. An enabled coalescer extends the linger time to its window, so bursts land in a single batch.
+// Break events are dropped: they end the wait, possibly with an empty batch, but never reach JS. Whichever
+// reader takes one (stopEventPump may emit several, see AsyncEngine) just returns early.
+Poco::JSON::Array::Ptr waitEventsBatch(EventQueueVar* eventQueue, EventStages& stages, size_t maxBatch,
+                                       int lingerMs) {
+    Poco::JSON::Array::Ptr events;
+    bool woken = false;
+    do {
+        int linger = std::max(lingerMs, stages.coalescer.windowMs());
+        events = EventRouter::dropBreakEvents(collectEvents(eventQueue, maxBatch, linger), woken);
+        events = stages.router.route(stages.coalescer.coalesce(events));
+    } while (events->size() == 0 && !woken);
+    return events;
+}
+
+}  // namespace
+
 namespace privmx {
 namespace webendpoint {
 namespace api {
@@ -70,11 +154,59 @@ void EventQueue_newEventQueue(int taskId) {
     });
 }
 void EventQueue_deleteEventQueue(int taskId, int ptr) {
-    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr] { delete (EventQueueVar*)ptr; });
+    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr] {
+        releaseEventStages(ptr);
+        delete (EventQueueVar*)ptr;
+    });
 }
 API_FUNCTION(EventQueue, emitBreakEvent)
 API_FUNCTION(EventQueue, waitEvent)
 API_FUNCTION(EventQueue, getEvent)
+void EventQueue_waitEvents(int taskId, int ptr, emscripten::val args) {
+    Poco::JSON::Array::Ptr argsArr = Mapper::map(args).extract<Poco::JSON::Array::Ptr>();
+    size_t maxBatch = std::max(1, argsArr->get(0).convert<int>());
+    int lingerMs = std::max(0, argsArr->get(1).convert<int>());
+    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr, maxBatch, lingerMs] {
+        return Poco::Dynamic::Var(waitEventsBatch((EventQueueVar*)ptr, *eventStages(ptr), maxBatch, lingerMs));
+    });
+}
+bool EventQueue_startEventPump(int ptr, emscripten::val callback, emscripten::val args) {
+    Poco::JSON::Array::Ptr argsArr = Mapper::map(args).extract<Poco::JSON::Array::Ptr>();
+    size_t maxBatch = std::max(1, argsArr->get(0).convert<int>());
+    int lingerMs = std::max(0, argsArr->get(1).convert<int>());
+    std::shared_ptr<EventStages> stages = eventStages(ptr);
+    return AsyncEngine::getInstance()->startEventPump(
+        [ptr, stages, maxBatch, lingerMs] {
+            return Poco::Dynamic::Var(waitEventsBatch((EventQueueVar*)ptr, *stages, maxBatch, lingerMs));
+        },
+        callback);
+}
+void EventQueue_addEventFilter(int taskId, int ptr, emscripten::val args) {
+    Poco::JSON::Array::Ptr argsArr = Mapper::map(args).extract<Poco::JSON::Array::Ptr>();
+    EventRouter::Filter filter = EventRouter::parseFilter(argsArr->get(0));
+    AsyncEngine::getInstance()->postWorkerTask(
+        taskId, [&, ptr, filter] { return eventStages(ptr)->router.addSubscriber(filter); });
+}
+void EventQueue_removeEventFilter(int taskId, int ptr, emscripten::val args) {
+    Poco::JSON::Array::Ptr argsArr = Mapper::map(args).extract<Poco::JSON::Array::Ptr>();
+    int subscriberId = argsArr->get(0).convert<int>();
+    AsyncEngine::getInstance()->postWorkerTask(
+        taskId, [&, ptr, subscriberId] { eventStages(ptr)->router.removeSubscriber(subscriberId); });
+}
+void EventQueue_setEventCoalescing(int taskId, int ptr, emscripten::val args) {
+    Poco::JSON::Array::Ptr argsArr = Mapper::map(args).extract<Poco::JSON::Array::Ptr>();
+    Poco::Dynamic::Var config = argsArr->get(0);
+    AsyncEngine::getInstance()->postWorkerTask(taskId,
+                                               [&, ptr, config] { eventStages(ptr)->coalescer.configure(config); });
+}
+void EventQueue_getEventCoalescingStats(int taskId, int ptr, emscripten::val) {
+    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr] { return eventStages(ptr)->coalescer.getStatsVar(); });
+}
+void EventQueue_stopEventPump(int taskId, int ptr) {
+    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr] {
+        AsyncEngine::getInstance()->stopEventPump([ptr] { ((EventQueueVar*)ptr)->emitBreakEvent(noArgs()); });
+    });
+}
 
 void Connection_newConnection(int taskId) {
     AsyncEngine::getInstance()->postWorkerTask(taskId, [&] {
@@ -94,7 +226,15 @@ API_FUNCTION(Connection, listContextUsers)
 API_FUNCTION(Connection, subscribeFor)
 API_FUNCTION(Connection, unsubscribeFrom)
 API_FUNCTION(Connection, buildSubscriptionQuery)
-API_FUNCTION(Connection, disconnect)
+void Connection_disconnect(int taskId, int ptr, emscripten::val args) {
+    Poco::Dynamic::Var argsVar = Mapper::map(args);
+    AsyncEngine::getInstance()->postWorkerTask(taskId, [&, ptr, argsVar] {
+        auto result = ((ConnectionVar*)ptr)->disconnect(argsVar);
+        // ECDH secrets cached by drv-ecc were derived with this session's keys
+        privmxDrvEcc_clearSecretCache();
+        return result;
+    });
+}
 
 void Connection_newUserVerifierInterface(int taskId, int connectionPtr, int interfaceBindId) {
     AsyncEngine::getInstance()->postWorkerTask(taskId, [&, connectionPtr, interfaceBindId] {
@@ -0,0 +1,159 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "EventCoalescer.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace privmx::webendpoint;
+
+namespace {
+
+const std::vector<std::string> INFO_ITEM_ID_FIELDS = {"messageId", "fileId"};
+const std::vector<std::string> DATA_ITEM_ID_FIELDS = {"threadId", "storeId", "kvdbId", "inboxId", "streamRoomId"};
+
+std::string optString(const Poco::JSON::Object::Ptr& obj, const std::string& field) {
+    if (obj.isNull() || !obj->has(field) || !obj->get(field).isString()) {
+        return std::string();
+    }
+    return obj->getValue<std::string>(field);
+}
+
+}  // namespace
+
+EventCoalescer::EventCoalescer() {
+    _config.types = defaultTypes();
+}
+
+std::set<std::string> EventCoalescer::defaultTypes() {
+    return {"threadMessageUpdated", "kvdbEntryUpdated", "storeFileUpdated", "threadUpdated", "storeUpdated",
+            "kvdbUpdated", "inboxUpdated", "threadStatsChanged", "storeStatsChanged", "kvdbStatsChanged"};
+}
+
+void EventCoalescer::configure(const Poco::Dynamic::Var& configVar) {
+    Poco::JSON::Object::Ptr obj = configVar.extract<Poco::JSON::Object::Ptr>();
+    Config config;
+    config.windowMs = std::max(0, obj->optValue<int>("windowMs", 0));
+    if (obj->has("types")) {
+        Poco::JSON::Array::Ptr types = obj->getArray("types");
+        for (size_t i = 0; i < types->size(); ++i) {
+            config.types.insert(types->getElement<std::string>(i));
+        }
+    } else {
+        config.types = defaultTypes();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _config = config;
+}
+
+int EventCoalescer::windowMs() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _config.windowMs;
+}
+
+Poco::JSON::Array::Ptr EventCoalescer::coalesce(const Poco::JSON::Array::Ptr& events) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_config.windowMs == 0) {
+        return events;
+    }
+    _received += events->size();
+    if (events->size() < 2) {
+        return events;
+    }
+    // Index of the last occurrence of every (type, itemId, connection and subscriptions) in this batch.
+    std::map<std::string, size_t> latest;
+    std::vector<std::string> keys(events->size());
+    for (size_t i = 0; i < events->size(); ++i) {
+        Poco::JSON::Object::Ptr event = events->getObject(i);
+        if (event.isNull()) {
+            continue;
+        }
+        std::string type = optString(event, "type");
+        if (_config.types.count(type) == 0) {
+            continue;
+        }
+        std::string itemId = getItemId(event);
+        if (itemId.empty()) {
+            continue;
+        }
+        keys[i] = type + '\n' + itemId + '\n' + getDeliveryKey(event);
+        latest[keys[i]] = i;
+    }
+    Poco::JSON::Array::Ptr result = new Poco::JSON::Array();
+    for (size_t i = 0; i < events->size(); ++i) {
+        if (!keys[i].empty() && latest[keys[i]] != i) {
+            _collapsed++;
+            continue;
+        }
+        result->add(events->get(i));
+    }
+    return result;
+}
+
+std::string EventCoalescer::getItemId(const Poco::JSON::Object::Ptr& event) {
+    Poco::JSON::Object::Ptr data = event->getObject("data");
+    if (data.isNull()) {
+        return std::string();
+    }
+    // Entries, messages and files identify themselves in their info block.
+    Poco::JSON::Object::Ptr info = data->getObject("info");
+    for (const auto& field : INFO_ITEM_ID_FIELDS) {
+        std::string id = optString(info, field);
+        if (!id.empty()) {
+            return id;
+        }
+    }
+    std::string kvdbId = optString(info, "kvdbId");
+    std::string key = optString(info, "key");
+    if (!kvdbId.empty() && !key.empty()) {
+        return kvdbId + '/' + key;
+    }
+    for (const auto& field : DATA_ITEM_ID_FIELDS) {
+        std::string id = optString(data, field);
+        if (!id.empty()) {
+            return id;
+        }
+    }
+    return std::string();
+}
+
+std::string EventCoalescer::getDeliveryKey(const Poco::JSON::Object::Ptr& event) {
+    // Events of other connections, or for other subscriptions, reach other listeners and must not replace each other
+    std::string key = event->has("connectionId") ? event->get("connectionId").convert<std::string>() : std::string();
+    Poco::JSON::Array::Ptr subscriptionsArr = event->getArray("subscriptions");
+    if (subscriptionsArr.isNull()) {
+        return key;
+    }
+    std::vector<std::string> subscriptions;
+    for (size_t i = 0; i < subscriptionsArr->size(); ++i) {
+        subscriptions.push_back(subscriptionsArr->get(i).convert<std::string>());
+    }
+    std::sort(subscriptions.begin(), subscriptions.end());
+    for (const auto& subscription : subscriptions) {
+        key += '\n' + subscription;
+    }
+    return key;
+}
+
+EventCoalescer::Stats EventCoalescer::getStats() const {
+    return Stats{_received.load(), _collapsed.load()};
+}
+
+Poco::Dynamic::Var EventCoalescer::getStatsVar() const {
+    Stats stats = getStats();
+    Poco::JSON::Object::Ptr result = new Poco::JSON::Object();
+    result->set("received", (Poco::Int64)stats.received);
+    result->set("collapsed", (Poco::Int64)stats.collapsed);
+    result->set("delivered", (Poco::Int64)(stats.received - stats.collapsed));
+    return result;
+}
@@ -0,0 +1,170 @@
+/*
+PrivMX Endpoint.
+Copyright © 2024 Simplito sp. z o.o.
+
+This file is part of the PrivMX Platform (https://privmx.dev).
+This software is Licensed under the PrivMX Free License.
+
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "EventRouter.hpp"
+
+#include <Poco/StringTokenizer.h>
+
+#include <algorithm>
+
+using namespace privmx::webendpoint;
+
+namespace {
+
+const std::string BREAK_EVENT_TYPE = "libBreakEvent";
+const std::vector<std::string> CONTAINER_ID_FIELDS = {"contextId", "threadId", "storeId",
+                                                      "kvdbId", "inboxId", "streamRoomId"};
+
+bool hasContainerIdField(const Poco::JSON::Object::Ptr& obj, const std::string& containerId) {
+    for (const auto& field : CONTAINER_ID_FIELDS) {
+        if (obj->has(field) && obj->get(field).isString() && obj->getValue<std::string>(field) == containerId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+EventRouter::Filter EventRouter::parseFilter(const Poco::Dynamic::Var& filterVar) {
+    Filter filter;
+    Poco::JSON::Object::Ptr obj = filterVar.extract<Poco::JSON::Object::Ptr>();
+    if (obj->has("type")) {
+        Poco::Dynamic::Var type = obj->get("type");
+        if (type.isString()) {
+            filter.types.push_back(type.convert<std::string>());
+        } else {
+            Poco::JSON::Array::Ptr types = type.extract<Poco::JSON::Array::Ptr>();
+            for (size_t i = 0; i < types->size(); ++i) {
+                filter.types.push_back(types->getElement<std::string>(i));
+            }
+        }
+    }
+    if (obj->has("channel")) {
+        filter.channel = obj->getValue<std::string>("channel");
+    }
+    if (obj->has("containerId")) {
+        filter.containerId = obj->getValue<std::string>("containerId");
+    }
+    if (obj->has("subscriptions")) {
+        Poco::JSON::Array::Ptr subscriptions = obj->getArray("subscriptions");
+        for (size_t i = 0; i < subscriptions->size(); ++i) {
+            filter.subscriptions.push_back(subscriptions->getElement<std::string>(i));
+        }
+    }
+    return filter;
+}
+
+Poco::JSON::Array::Ptr EventRouter::dropBreakEvents(const Poco::JSON::Array::Ptr& events, bool& found) {
+    found = false;
+    Poco::JSON::Array::Ptr result = new Poco::JSON::Array();
+    for (size_t i = 0; i < events->size(); ++i) {
+        Poco::JSON::Object::Ptr event = events->getObject(i);
+        if (!event.isNull() && event->optValue<std::string>("type", "") == BREAK_EVENT_TYPE) {
+            found = true;
+            continue;
+        }
+        result->add(events->get(i));
+    }
+    return result;
+}
+
+int EventRouter::addSubscriber(const Filter& filter) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    int subscriberId = _nextSubscriberId++;
+    _subscribers.emplace(subscriberId, filter);
+    return subscriberId;
+}
+
+void EventRouter::removeSubscriber(int subscriberId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _subscribers.erase(subscriberId);
+}
+
+Poco::JSON::Array::Ptr EventRouter::route(const Poco::JSON::Array::Ptr& events) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_subscribers.empty()) {
+        return events;
+    }
+    Poco::JSON::Array::Ptr result = new Poco::JSON::Array();
+    for (size_t i = 0; i < events->size(); ++i) {
+        Poco::JSON::Object::Ptr event = events->getObject(i);
+        if (event.isNull()) {
+            continue;
+        }
+        Poco::JSON::Array::Ptr targets = new Poco::JSON::Array();
+        for (const auto& [subscriberId, filter] : _subscribers) {
+            if (matches(filter, event)) {
+                targets->add(subscriberId);
+            }
+        }
+        if (targets->size() > 0) {
+            event->set("targets", targets);
+            result->add(event);
+        }
+    }
+    return result;
+}
+
+bool EventRouter::matches(const Filter& filter, const Poco::JSON::Object::Ptr& event) {
+    if (!filter.types.empty()) {
+        std::string type = event->optValue<std::string>("type", "");
+        if (std::find(filter.types.begin(), filter.types.end(), type) == filter.types.end()) {
+            return false;
+        }
+    }
+    if (!filter.channel.empty()) {
+        std::string channel = event->optValue<std::string>("channel", "");
+        if (channel.compare(0, filter.channel.size(), filter.channel) != 0) {
+            return false;
+        }
+    }
+    if (!filter.containerId.empty() && !containsContainerId(event, filter.containerId)) {
+        return false;
+    }
+    if (!filter.subscriptions.empty() && !containsSubscription(event, filter.subscriptions)) {
+        return false;
+    }
+    return true;
+}
+
+bool EventRouter::containsSubscription(const Poco::JSON::Object::Ptr& event, const std::vector<std::string>& ids) {
+    Poco::JSON::Array::Ptr subscriptions = event->getArray("subscriptions");
+    if (subscriptions.isNull()) {
+        return false;
+    }
+    for (size_t i = 0; i < subscriptions->size(); ++i) {
+        Poco::Dynamic::Var subscription = subscriptions->get(i);
+        if (subscription.isString() &&
+            std::find(ids.begin(), ids.end(), subscription.extract<std::string>()) != ids.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EventRouter::containsContainerId(const Poco::JSON::Object::Ptr& event, const std::string& containerId) {
+    // Channels look like "thread/<threadId>/messages" or "context/<contextId>/<name>".
+    Poco::StringTokenizer segments(event->optValue<std::string>("channel", ""), "/");
+    if (std::find(segments.begin(), segments.end(), containerId) != segments.end()) {
+        return true;
+    }
+    Poco::JSON::Object::Ptr data = event->getObject("data");
+    if (data.isNull()) {
+        return false;
+    }
+    if (hasContainerIdField(data, containerId)) {
+        return true;
+    }
+    // Item events (messages, files, entries) carry the container id in their info block.
+    Poco::JSON::Object::Ptr info = data->getObject("info");
+    return !info.isNull() && hasContainerIdField(info, containerId);
+}